@@ -0,0 +1,1161 @@
+#define _GNU_SOURCE
+#include "archive.h"
+
+/* ajoute les occurences de t à total */
+static void cumuler(long total[], int t[])
+{
+    int i;
+    for (i = 0; i < 256; i++)
+    {
+        total[i] += t[i];
+    }
+}
+
+/* copie taille octets de src vers dst en calculant leur CRC32C */
+static void copie_controlee(FILE *src, FILE *dst, long taille, unsigned int *crc, char *nom)
+{
+    *crc = 0;
+    if (copie_crc(src, dst, taille, crc) != 0)
+    {
+        printf("Erreur lors de la copie de %s\n", nom);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* format d'origine : en-tête texte avec l'alphabet puis codes_fichier, ou membre stocké si le codage ne rapporte rien */
+static void compression_origine(FILE *fic_dest, FILE *fic_depart, char *chemin, unsigned int *crc)
+{
+    /* arbre, alphabet, table et tampons sont ceux du contexte du fil : rien n'est alloué d'un fichier à l'autre */
+    contexte_huffman *c = contexte_du_fil();
+
+    reinitialiser_contexte(c);
+    occurence(fic_depart, c->occurences);
+    construire_arbre(c);
+
+    rewind(fic_depart);
+    if (stockage_preferable(c->alphabet, chemin))
+    {
+        en_tete_stocke(fic_dest, nb_car_total(c->alphabet), chemin);
+        copie_controlee(fic_depart, fic_dest, nb_car_total(c->alphabet), crc, chemin);
+    }
+    else
+    {
+        en_tete(fic_dest, c->alphabet, chemin);
+        /* les codes de l'en-tête, mis en table, donnent les mêmes bits que codes_fichier, contrôle compris en un seul passage */
+        if (table_origine(c->alphabet, &c->table) != 0)
+        {
+            printf("Erreur lors du codage de %s\n", chemin);
+            exit(EXIT_FAILURE);
+        }
+        preparer_tampons(c, TAILLE_FENETRE, TAILLE_SORTIE_FENETRE);
+        coder_fichier(fic_depart, fic_dest, &c->table, NULL, c->entree, c->sortie, crc);
+    }
+    fputs("\n\n\n", fic_dest);
+}
+
+/* compresse fic_depart en un membre complet à la position courante de fic_dest */
+static void compresser_contenu(FILE *fic_dest, FILE *fic_depart, fichier_source *f, options_compression *o, unsigned int *crc, index_blocs *index)
+{
+    estimation e;
+
+    estimer_flux(fic_depart, f->taille, f->chemin, &e);
+    rewind(fic_depart);
+    /* un petit fichier est codé avec la table du dictionnaire, sans compter ses occurences */
+    if (o->table_dictionnaire != NULL && f->taille <= TAILLE_MAX_DICTIONNAIRE)
+    {
+        compression_dictionnaire(fic_dest, fic_depart, f->taille, f->chemin, o->table_dictionnaire, o->id_table, crc);
+    }
+    /* les fichiers que l'échantillonnage juge incompressibles sont stockés sans lire leurs occurences */
+    else if (e.stocker)
+    {
+        en_tete_stocke(fic_dest, e.taille, f->chemin);
+        copie_controlee(fic_depart, fic_dest, e.taille, crc, f->chemin);
+        fputs("\n\n\n", fic_dest);
+    }
+    else if (o->format_origine)
+    {
+        compression_origine(fic_dest, fic_depart, f->chemin, crc);
+    }
+    /* par défaut, membre en blocs dont la taille est celle conseillée par l'échantillonnage */
+    else
+    {
+        compression_blocs(fic_dest, fic_depart, f->taille, f->chemin, o->taille_bloc > 0 ? o->taille_bloc : e.taille_bloc, crc, index);
+    }
+}
+
+/* tâches de l'ordonnanceur : le résultat est écrit en mémoire, l'archive n'est touchée que par le fil principal */
+static void coder_membre(tache *t)
+{
+    travail_segment *s = (travail_segment *)t;
+    FILE *fic_depart, *fic_dest;
+
+    if ((fic_depart = ouvrir_source(s->f)) == NULL || (fic_dest = open_memstream(&s->octets, &s->taille)) == NULL)
+    {
+        printf("Impossible d'ouvrir le fichier_depart %s pour lecture \n", s->f->chemin);
+        exit(EXIT_FAILURE);
+    }
+    compresser_contenu(fic_dest, fic_depart, s->f, s->o, &s->crc, &s->index);
+    fclose(fic_depart);
+    fclose(fic_dest);
+}
+
+static void coder_segment(tache *t)
+{
+    travail_segment *s = (travail_segment *)t;
+    FILE *fic_depart, *fic_dest;
+
+    if ((fic_depart = fopen(s->f->chemin, "r")) == NULL || fseek(fic_depart, s->debut, SEEK_SET) != 0 ||
+        (fic_dest = open_memstream(&s->octets, &s->taille)) == NULL)
+    {
+        printf("Impossible d'ouvrir le fichier_depart %s pour lecture \n", s->f->chemin);
+        exit(EXIT_FAILURE);
+    }
+    s->lu = segment_blocs(fic_dest, fic_depart, s->longueur, s->taille_bloc, s->debut, &s->crc, &s->index);
+    fclose(fic_depart);
+    fclose(fic_dest);
+}
+
+/* nombre de segments d'un gros fichier codés en avance sur l'écriture : assez pour occuper tous les fils, pas assez pour tout garder en mémoire */
+static int segments_en_avance(ordonnanceur *ord)
+{
+    return 2 * (ord->nb_fils > 0 ? ord->nb_fils : 1);
+}
+
+/* octets d'origine confiés aux fils et pas encore écrits au-delà desquels les fichiers suivants d'un lot attendent l'écriture :
+   le même volume que les segments en avance d'un gros fichier */
+static long octets_en_avance(ordonnanceur *ord)
+{
+    return segments_en_avance(ord) * (long)TAILLE_SEGMENT;
+}
+
+static void soumettre_segment(travail_fichier *t)
+{
+    tache *suivante = &t->segments[t->nb_soumis++].t;
+    soumettre_taches(t->ordonnanceur, &suivante, 1);
+}
+
+/* vrai si le fichier i du lot sera sans doute un doublon ou recopié du cache : inutile de le coder d'avance */
+static int deja_connu(fichier_source fichiers[], int i, options_compression *o, repertoire *r)
+{
+    entree_repertoire e;
+    int j;
+
+    e.nom = fichiers[i].chemin;
+    e.taille = fichiers[i].taille;
+    e.mtime = fichiers[i].mtime;
+    e.empreinte = fichiers[i].empreinte;
+    if (chercher_empreinte(r, &e) != NULL)
+    {
+        return 1;
+    }
+    for (j = 0; j < i && e.empreinte != 0; j++)
+    {
+        if (!fichiers[j].erreur && fichiers[j].empreinte == e.empreinte && fichiers[j].taille == e.taille)
+        {
+            return 1;
+        }
+    }
+    return o->cache != NULL && chercher_dans_cache(o->cache, &e) != NULL;
+}
+
+void planifier_lot(ordonnanceur *ord, fichier_source fichiers[], int nb, options_compression *o, repertoire *r, travail_fichier travaux[])
+{
+    tache **taches;
+    travail_fichier *t;
+    travail_segment *s;
+    estimation e;
+    long taille_bloc, longueur;
+    int i, k, nb_taches = 0, avance = segments_en_avance(ord);
+
+    if ((taches = (tache **)malloc((nb + avance) * sizeof(tache *))) == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < nb; i++)
+    {
+        t = &travaux[i];
+        t->ordonnanceur = ord;
+        t->segments = NULL;
+        t->nb_segments = t->nb_soumis = 0;
+        t->entier = 1;
+        if (fichiers[i].erreur || deja_connu(fichiers, i, o, r))
+        {
+            continue;
+        }
+        taille_bloc = longueur = 0;
+        if (!o->format_origine && fichiers[i].taille > TAILLE_SEGMENT)
+        {
+            /* gros fichier stocké : c'est une simple copie, faite à l'écriture */
+            if (estimer_fichier(fichiers[i].chemin, &e) != 0 || e.stocker)
+            {
+                continue;
+            }
+            taille_bloc = o->taille_bloc > 0 ? o->taille_bloc : e.taille_bloc;
+            longueur = taille_bloc > TAILLE_SEGMENT ? taille_bloc : TAILLE_SEGMENT;
+            t->entier = 0;
+            t->nb_segments = (int)((fichiers[i].taille + longueur - 1) / longueur);
+        }
+        else
+        {
+            t->nb_segments = 1;
+        }
+        if ((t->segments = (travail_segment *)malloc(t->nb_segments * sizeof(travail_segment))) == NULL)
+        {
+            printf("Erreur d'allocation memoire\n");
+            exit(EXIT_FAILURE);
+        }
+        for (k = 0; k < t->nb_segments; k++)
+        {
+            s = &t->segments[k];
+            s->f = &fichiers[i];
+            s->o = o;
+            s->debut = k * longueur;
+            s->longueur = t->entier ? fichiers[i].taille : (k == t->nb_segments - 1 ? fichiers[i].taille - s->debut : longueur);
+            s->taille_bloc = taille_bloc;
+            s->octets = NULL;
+            s->taille = 0;
+            s->lu = 0;
+            s->index.blocs = NULL;
+            s->index.nb = s->index.capacite = 0;
+            s->t.cout = s->longueur;
+            s->t.executer = t->entier ? coder_membre : coder_segment;
+        }
+        /* les segments des gros fichiers partent au fur et à mesure de l'écriture, les premiers tout de suite s'il reste de la place ;
+           les fichiers entiers partent avec avancer_lot */
+        while (!t->entier && t->nb_soumis < t->nb_segments && avance > 0)
+        {
+            taches[nb_taches++] = &t->segments[t->nb_soumis++].t;
+            avance--;
+        }
+    }
+    soumettre_taches(ord, taches, nb_taches);
+    free(taches);
+    avancer_lot(travaux, nb);
+}
+
+void avancer_lot(travail_fichier travaux[], int nb)
+{
+    tache **taches;
+    travail_fichier *t;
+    long en_cours = 0;
+    int i, k, nb_taches = 0;
+
+    for (i = 0; i < nb; i++)
+    {
+        for (k = 0; k < travaux[i].nb_soumis; k++)
+        {
+            en_cours += travaux[i].segments[k].longueur;
+        }
+    }
+    if ((taches = (tache **)malloc((nb > 0 ? nb : 1) * sizeof(tache *))) == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    /* dans l'ordre de l'écriture, tant que le volume en cours le permet ; le premier en attente part toujours si rien n'est en cours */
+    for (i = 0; i < nb; i++)
+    {
+        t = &travaux[i];
+        if (!t->entier || t->segments == NULL || t->nb_soumis > 0)
+        {
+            continue;
+        }
+        if (en_cours > 0 && en_cours + t->segments[0].longueur > octets_en_avance(t->ordonnanceur))
+        {
+            break;
+        }
+        en_cours += t->segments[0].longueur;
+        taches[nb_taches++] = &t->segments[t->nb_soumis++].t;
+    }
+    if (nb_taches > 0)
+    {
+        soumettre_taches(travaux[0].ordonnanceur, taches, nb_taches);
+    }
+    free(taches);
+}
+
+void liberer_travail(travail_fichier *t)
+{
+    int i;
+    for (i = 0; i < t->nb_soumis; i++)
+    {
+        attendre_tache(t->ordonnanceur, &t->segments[i].t);
+    }
+    for (i = 0; i < t->nb_segments; i++)
+    {
+        free(t->segments[i].octets);
+        liberer_index(&t->segments[i].index);
+    }
+    free(t->segments);
+    t->segments = NULL;
+    t->nb_segments = t->nb_soumis = 0;
+}
+
+/* recopie dans fic_dest ce que les tâches de t ont produit, dans l'ordre, et complète entree */
+static void ecrire_travail(FILE *fic_dest, travail_fichier *t, entree_repertoire *entree)
+{
+    travail_segment *s;
+    bloc_indexe *b;
+    long position = 0;
+    int i, j;
+
+    entree->crc = 0;
+    if (!t->entier)
+    {
+        fprintf(fic_dest, "B%ld\n\n%s\n", entree->taille, entree->nom);
+        position = ftell(fic_dest) - entree->position;
+    }
+    for (i = 0; i < t->nb_segments; i++)
+    {
+        while (t->nb_soumis < t->nb_segments && t->nb_soumis < i + segments_en_avance(t->ordonnanceur))
+        {
+            soumettre_segment(t);
+        }
+        s = &t->segments[i];
+        attendre_tache(t->ordonnanceur, &s->t);
+        if (fwrite(s->octets, 1, s->taille, fic_dest) != s->taille)
+        {
+            printf("Erreur lors de l'ecriture de %s dans l'archive\n", entree->nom);
+            exit(EXIT_FAILURE);
+        }
+        for (j = 0; j < s->index.nb; j++)
+        {
+            b = &s->index.blocs[j];
+            indexer_bloc(&entree->index, b->debut, b->position + position, b->position_table < 0 ? -1 : b->position_table + position);
+        }
+        entree->crc = t->entier ? s->crc : crc32c_combiner(entree->crc, s->crc, s->lu);
+        position += s->taille;
+        /* la mémoire d'un segment écrit est rendue tout de suite */
+        free(s->octets);
+        s->octets = NULL;
+        liberer_index(&s->index);
+    }
+    if (!t->entier)
+    {
+        fputs("\n\n\n", fic_dest);
+    }
+}
+
+void ajouter_fichier(FILE *fic_dest, fichier_source *f, travail_fichier *t, options_compression *o, repertoire *r)
+{
+    FILE *fic_depart;
+    entree_repertoire entree, *identique;
+    char *chemin = f->chemin;
+
+    /* le fichier n'est ouvert qu'une fois, en mémoire s'il a été lu d'avance, et rembobiné entre les étapes */
+    if (f->erreur || (fic_depart = ouvrir_source(f)) == NULL)
+    {
+        printf("Impossible d'ouvrir le fichier_depart %s pour lecture \n", chemin);
+        exit(EXIT_FAILURE);
+    }
+    entree.position = ftell(fic_dest);
+    entree.position_table = -1;
+    entree.index.blocs = NULL;
+    entree.index.nb = entree.index.capacite = 0;
+    entree.nom = chemin;
+    entree.taille = f->taille;
+    entree.mtime = f->mtime;
+    entree.empreinte = f->empreinte;
+
+    /* même contenu qu'un fichier déjà archivé, qui n'a pas été remplacé depuis sous le même nom : simple référence */
+    if ((identique = chercher_empreinte(r, &entree)) != NULL && chercher_entree(r, identique->nom) == identique &&
+        fichiers_identiques(identique->nom, fic_depart))
+    {
+        fprintf(fic_dest, "L%ld\n\n%s\n\n%s\n\n\n\n", entree.taille, chemin, identique->nom);
+        entree.crc = identique->crc;
+    }
+    /* fichier inchangé depuis l'archive précédente : son membre est recopié sans être recompressé */
+    else if (o->cache != NULL && copier_depuis_cache(o->cache, fic_dest, &entree) == 0)
+    {
+        fclose(fic_depart);
+        ajouter_entree(r, &entree);
+        return;
+    }
+    /* codé d'avance par l'ordonnanceur */
+    else if (t != NULL && t->segments != NULL)
+    {
+        ecrire_travail(fic_dest, t, &entree);
+    }
+    else
+    {
+        compresser_contenu(fic_dest, fic_depart, f, o, &entree.crc, &entree.index);
+    }
+    fclose(fic_depart);
+    entree.taille_membre = ftell(fic_dest) - entree.position;
+    ajouter_entree(r, &entree);
+}
+
+void compression_solide(FILE *fic_dest, char **liste_fichiers, int nb_fichiers, ordonnanceur *ord, repertoire *r)
+{
+    int fic, i, t[256];
+    long occ[256], total[256] = {0}, taille, taille_codee;
+    FILE *fic_depart;
+    table_codes table;
+    estimation e;
+    entree_repertoire entree;
+    struct stat st;
+    contexte_huffman *c = contexte_du_fil();
+
+    /* 1er passage : occurences cumulées de tous les fichiers compressibles */
+    for (fic = 0; fic < nb_fichiers; fic++)
+    {
+        /* un contenu incompressible fausserait la table de tous les autres ; seule son entropie compte ici, car un membre P
+           n'a pas d'en-tête à lui : e.stocker, qui en compte un par fichier, ferait stocker presque tous les petits fichiers */
+        if (estimer_fichier(liste_fichiers[fic], &e) == 0 && e.entropie * 100 > 8 * SEUIL_STOCKAGE)
+        {
+            continue;
+        }
+        if ((fic_depart = fopen(liste_fichiers[fic], "r")) == NULL)
+        {
+            printf("Impossible d'ouvrir le fichier_depart %s pour lecture \n", liste_fichiers[fic]);
+            exit(EXIT_FAILURE);
+        }
+        occurence(fic_depart, t);
+        fclose(fic_depart);
+        cumuler(total, t);
+    }
+
+    longueurs_codes(total, table.longueurs);
+    construire_table(&table);
+    entree.position_table = ftell(fic_dest);
+    entree.index.blocs = NULL;
+    entree.index.nb = entree.index.capacite = 0;
+    fputs("T\n", fic_dest);
+    ecrire_table(fic_dest, table.longueurs);
+    preparer_tampons(c, TAILLE_FENETRE, TAILLE_SORTIE_FENETRE);
+
+    /* 2ème passage : chaque membre est codé avec la table partagée, ou stocké si elle ne lui convient pas (coût exact) */
+    for (fic = 0; fic < nb_fichiers; fic++)
+    {
+        if ((fic_depart = fopen(liste_fichiers[fic], "r")) == NULL)
+        {
+            printf("Impossible d'ouvrir le fichier_depart %s pour lecture \n", liste_fichiers[fic]);
+            exit(EXIT_FAILURE);
+        }
+        occurence(fic_depart, t);
+        rewind(fic_depart);
+        entree.position = ftell(fic_dest);
+        taille = 0;
+        for (i = 0; i < 256; i++)
+        {
+            occ[i] = t[i];
+            taille += t[i];
+        }
+        taille_codee = (long)((cout_bits(occ, table.longueurs) + 7) / 8);
+        if (table_couvre(occ, table.longueurs) && taille_codee * 100 <= taille * SEUIL_STOCKAGE)
+        {
+            /* la taille annoncée est exacte : un fichier modifié depuis le comptage donnerait un membre illisible */
+            fprintf(fic_dest, "P%ld %ld\n\n%s\n", taille, taille_codee, liste_fichiers[fic]);
+            if (coder_fichier(fic_depart, fic_dest, &table, ord, c->entree, c->sortie, &entree.crc) != taille_codee)
+            {
+                printf("Le fichier %s a change pendant sa compression\n", liste_fichiers[fic]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else
+        {
+            en_tete_stocke(fic_dest, taille, liste_fichiers[fic]);
+            copie_controlee(fic_depart, fic_dest, taille, &entree.crc, liste_fichiers[fic]);
+        }
+        fputs("\n\n\n", fic_dest);
+        fclose(fic_depart);
+        entree.taille_membre = ftell(fic_dest) - entree.position;
+        entree.taille = taille;
+        entree.mtime = stat(liste_fichiers[fic], &st) == 0 ? (long)st.st_mtime : 0;
+        entree.empreinte = 0;
+        entree.nom = liste_fichiers[fic];
+        ajouter_entree(r, &entree);
+    }
+}
+
+int table_partagee(FILE *fic, table_codes *t)
+{
+    int c = fgetc(fic);
+    if (c != 'T')
+    {
+        ungetc(c, fic);
+        return 0;
+    }
+    if (fgetc(fic) != '\n' || lire_table(fic, t->longueurs) != 0)
+    {
+        printf("erreur de lecture du fichier compressé\n");
+        exit(EXIT_FAILURE);
+    }
+    construire_table(t);
+    return 1;
+}
+
+long membre_partage(FILE *fic, long *taille_codee)
+{
+    long taille;
+    int c = fgetc(fic);
+    if (c != 'P')
+    {
+        ungetc(c, fic);
+        return -1;
+    }
+    if (fscanf(fic, "%ld %ld", &taille, taille_codee) != 2 || fgetc(fic) != '\n')
+    {
+        printf("erreur de lecture du fichier compressé\n");
+        exit(EXIT_FAILURE);
+    }
+    return taille;
+}
+
+/* si le membre qui commence à la position courante est un doublon, lit sa 1ère ligne et retourne sa taille d'origine ;
+   retourne -1 sinon sans rien consommer */
+static long membre_doublon(FILE *fic)
+{
+    long taille;
+    int c = fgetc(fic);
+    if (c != 'L')
+    {
+        ungetc(c, fic);
+        return -1;
+    }
+    if (fscanf(fic, "%ld", &taille) != 1 || fgetc(fic) != '\n')
+    {
+        printf("erreur de lecture du fichier compressé\n");
+        exit(EXIT_FAILURE);
+    }
+    return taille;
+}
+
+/* si l'entrée e est un doublon, écrit dans source le nom du fichier dont il a le contenu et retourne 1 ; retourne 0 sinon */
+static int doublon(FILE *fic, entree_repertoire *e, char *source)
+{
+    char nom[500], *p_nom = nom;
+    entete_membre m;
+
+    if (fseek(fic, e->position, SEEK_SET) != 0 || fgetc(fic) != 'L')
+    {
+        return 0;
+    }
+    fseek(fic, e->position, SEEK_SET);
+    lire_entete_membre(fic, &m);
+    lecture_nom_fichier(fic, &p_nom);
+    lecture_nom_fichier(fic, &source);
+    return 1;
+}
+
+void lire_entete_membre(FILE *fic, entete_membre *m)
+{
+    m->taille_codee = 0;
+    m->table = -1;
+    if ((m->taille = membre_stocke(fic)) >= 0)
+    {
+        m->type = 'S';
+    }
+    else if ((m->taille = membre_partage(fic, &m->taille_codee)) >= 0)
+    {
+        m->type = 'P';
+    }
+    else if ((m->taille = membre_blocs(fic)) >= 0)
+    {
+        m->type = 'B';
+    }
+    else if ((m->taille = membre_dictionnaire(fic, &m->table, &m->taille_codee)) >= 0)
+    {
+        m->type = 'R';
+    }
+    else if ((m->taille = membre_doublon(fic)) >= 0)
+    {
+        m->type = 'L';
+    }
+    else
+    {
+        m->type = 'H';
+    }
+}
+
+int decoder_membre(FILE *fic, FILE *fic_decom, entete_membre *m, noeud *alphabet[], extraction *x, unsigned int *crc)
+{
+    noeud *arbre_huffman[256];
+    table_codes table;
+    FILE *fic_temp;
+
+    *crc = 0;
+    switch (m->type)
+    {
+    case 'S':
+        return copie_crc(fic, fic_decom, m->taille, crc);
+    case 'B':
+        return decompression_blocs(fic, fic_decom, m->taille, crc);
+    case 'P':
+        return decoder_fichier(fic, fic_decom, &x->table_solide, m->taille, m->taille_codee, crc);
+    case 'R':
+        if (x->dico == NULL || x->dico->tables[m->table] == NULL)
+        {
+            printf("La table %d est absente du dictionnaire (option -D)\n", m->table);
+            return -1;
+        }
+        return decoder_fichier(fic, fic_decom, x->dico->tables[m->table], m->taille, m->taille_codee, crc);
+    case 'L':
+        /* un doublon n'a pas de contenu propre : il est extrait depuis sa source (extraire_membre) */
+        return -1;
+    default:
+        /* codes de l'en-tête utilisables tels quels : décodage par table, en parallèle */
+        if (table_origine(alphabet, &table) == 0)
+        {
+            return decoder_origine(fic, fic_decom, &table, nb_car_total(alphabet), bits_codes(alphabet), x->ordonnanceur, crc);
+        }
+        /* sinon, decompression écrit caractère par caractère : le contrôle se fait en relisant ce qui a été décodé */
+        if ((fic_temp = fic_decom != NULL ? fic_decom : tmpfile()) == NULL)
+        {
+            return -1;
+        }
+        recreation_huffman(alphabet, arbre_huffman);
+        decompression(fic, fic_temp, arbre_huffman[0], alphabet);
+        fflush(fic_temp);
+        rewind(fic_temp);
+        *crc = crc32c_fichier(fic_temp);
+        if (fic_decom == NULL)
+        {
+            fclose(fic_temp);
+        }
+        return 0;
+    }
+}
+
+/* chemin du fichier extrait, dans dossier s'il est donné ; crée les dossiers qui manquent */
+static void chemin_extraction(char *dossier, char *nom, char *chemin, size_t taille)
+{
+    char *dernier_slash;
+
+    if (dossier != NULL)
+    {
+        snprintf(chemin, taille, "%s/%s", dossier, nom);
+    }
+    else
+    {
+        snprintf(chemin, taille, "%s", nom);
+    }
+    dernier_slash = strrchr(chemin, '/');
+    if (dernier_slash != NULL && dernier_slash != chemin)
+    {
+        *dernier_slash = '\0';
+        mkdir_p(chemin);
+        *dernier_slash = '/';
+    }
+}
+
+int extraire_membre(FILE *fic, extraction *x)
+{
+    int i, c, erreur;
+    long position;
+    unsigned int crc;
+    entete_membre m;
+    entree_repertoire *e;
+    noeud *alphabet[256], feuilles[256];
+    char nom[500], source[500], chemin[1024], chemin_source[1024], *p_nom = nom, *p_source = source;
+    FILE *fic_decom;
+
+    /* une table partagée vaut pour tous les membres qui la suivent */
+    while (table_partagee(fic, &x->table_solide))
+    {
+    }
+    /* fin de l'archive ou début du répertoire central */
+    if ((c = fgetc(fic)) == EOF || c == 'I')
+    {
+        return 1;
+    }
+    ungetc(c, fic);
+    position = ftell(fic);
+
+    for (i = 0; i < 256; i++)
+    {
+        alphabet[i] = NULL;
+    }
+    lire_entete_membre(fic, &m);
+    if (m.type == 'H')
+    {
+        rec_alph_fich(fic, alphabet, feuilles, &p_nom);
+    }
+    else
+    {
+        lecture_nom_fichier(fic, &p_nom);
+    }
+
+    chemin_extraction(x->dossier, x->renommer != NULL ? x->renommer : nom, chemin, sizeof(chemin));
+    /* un doublon reprend le fichier identique, déjà extrait puisqu'il le précède dans l'archive */
+    if (m.type == 'L')
+    {
+        lecture_nom_fichier(fic, &p_source);
+        chemin_extraction(x->dossier, source, chemin_source, sizeof(chemin_source));
+        if (lier_ou_copier(chemin_source, chemin) != 0 || fscanf(fic, "\n\n\n") != 0)
+        {
+            printf("Impossible de creer le fichier %s depuis %s\n", chemin, chemin_source);
+            return -1;
+        }
+        printf("Le fichier %s a été décompressé.\n", chemin);
+        return 0;
+    }
+    /* le chemin a pu être lié à un doublon par une extraction précédente : l'ouvrir tel quel changerait aussi le doublon */
+    unlink(chemin);
+    if ((fic_decom = fopen(chemin, "w+")) == NULL)
+    {
+        printf("Impossible de creer le fichier %s\n", chemin);
+        return -1;
+    }
+    erreur = decoder_membre(fic, fic_decom, &m, alphabet, x, &crc);
+    if (fclose(fic_decom) != 0 || erreur != 0 || fscanf(fic, "\n\n\n") != 0)
+    {
+        printf("Erreur dans le fichier compressé\n");
+        return -1;
+    }
+    /* le contenu décodé doit avoir le CRC32C noté dans le répertoire central */
+    if ((e = entree_a_position(&x->repertoire, position)) != NULL && e->crc != crc)
+    {
+        printf("Le fichier %s est corrompu (CRC32C %08x au lieu de %08x)\n", chemin, crc, e->crc);
+        return -1;
+    }
+    printf("Le fichier %s a été décompressé.\n", chemin);
+    return 0;
+}
+
+/* membre qui porte le contenu de e : e lui-même, ou sa source si c'est un doublon ; NULL si la source est introuvable */
+static entree_repertoire *resoudre_doublon(FILE *fic, repertoire *r, entree_repertoire *e)
+{
+    char source[500];
+    return doublon(fic, e, source) ? chercher_source(r, source, e) : e;
+}
+
+int extraire_selection(FILE *fic, char *nom, extraction *x)
+{
+    repertoire r;
+    entree_repertoire *e;
+    int erreur;
+
+    if (lire_repertoire(fic, &r) != 0)
+    {
+        printf("L'archive n'a pas de repertoire central\n");
+        return -1;
+    }
+    if ((e = chercher_entree(&r, nom)) == NULL || (e = resoudre_doublon(fic, &r, e)) == NULL)
+    {
+        printf("Le fichier %s n'est pas dans l'archive\n", nom);
+        liberer_repertoire(&r);
+        return -1;
+    }
+    /* un membre P a besoin de la table partagée qui le précède */
+    if (e->position_table >= 0 && (fseek(fic, e->position_table, SEEK_SET) != 0 || !table_partagee(fic, &x->table_solide)))
+    {
+        liberer_repertoire(&r);
+        return -1;
+    }
+    /* pour un doublon, c'est le membre source qui est extrait, sous le nom demandé */
+    x->renommer = nom;
+    erreur = fseek(fic, e->position, SEEK_SET) != 0 || extraire_membre(fic, x) != 0 ? -1 : 0;
+    x->renommer = NULL;
+    liberer_repertoire(&r);
+    return erreur;
+}
+
+/* membre sans index de blocs : décode les debut + longueur premiers octets dans un fichier temporaire puis n'en garde que la plage */
+static int plage_sequentielle(FILE *fic, entree_repertoire *e, long debut, long longueur, FILE *fic_decom, extraction *x)
+{
+    entete_membre m;
+    noeud *alphabet[256], feuilles[256];
+    char nom[500], *p_nom = nom;
+    FILE *fic_temp;
+    unsigned int crc;
+    int i, erreur;
+
+    for (i = 0; i < 256; i++)
+    {
+        alphabet[i] = NULL;
+    }
+    if (e->position_table >= 0 && (fseek(fic, e->position_table, SEEK_SET) != 0 || !table_partagee(fic, &x->table_solide)))
+    {
+        return -1;
+    }
+    if (fseek(fic, e->position, SEEK_SET) != 0)
+    {
+        return -1;
+    }
+    lire_entete_membre(fic, &m);
+    if (m.type == 'H')
+    {
+        rec_alph_fich(fic, alphabet, feuilles, &p_nom);
+    }
+    else
+    {
+        lecture_nom_fichier(fic, &p_nom);
+    }
+    /* un membre stocké se lit directement à la bonne position */
+    if (m.type == 'S')
+    {
+        return fseek(fic, debut, SEEK_CUR) != 0 || copie_brute(fic, fic_decom, longueur) != 0 ? -1 : 0;
+    }
+    if ((fic_temp = tmpfile()) == NULL)
+    {
+        return -1;
+    }
+    /* les membres P et R s'arrêtent à la fin de la plage */
+    if (m.type == 'P' || m.type == 'R')
+    {
+        m.taille = debut + longueur;
+    }
+    erreur = decoder_membre(fic, fic_temp, &m, alphabet, x, &crc) != 0 || fseek(fic_temp, debut, SEEK_SET) != 0 ||
+             copie_brute(fic_temp, fic_decom, longueur) != 0;
+    fclose(fic_temp);
+    return erreur ? -1 : 0;
+}
+
+int extraire_plage(FILE *fic, char *nom, long debut, long longueur, FILE *fic_decom, extraction *x)
+{
+    repertoire r;
+    entree_repertoire *e;
+    int erreur = 0;
+
+    if (lire_repertoire(fic, &r) != 0)
+    {
+        printf("L'archive n'a pas de repertoire central\n");
+        return -1;
+    }
+    if ((e = chercher_entree(&r, nom)) == NULL || (e = resoudre_doublon(fic, &r, e)) == NULL)
+    {
+        printf("Le fichier %s n'est pas dans l'archive\n", nom);
+        liberer_repertoire(&r);
+        return -1;
+    }
+    /* la plage est ramenée à la taille du fichier */
+    if (debut > e->taille)
+    {
+        debut = e->taille;
+    }
+    if (longueur > e->taille - debut)
+    {
+        longueur = e->taille - debut;
+    }
+    if (longueur > 0)
+    {
+        if (e->index.nb > 0)
+        {
+            erreur = plage_blocs(fic, e->position, &e->index, debut, longueur, fic_decom);
+        }
+        else
+        {
+            erreur = plage_sequentielle(fic, e, debut, longueur, fic_decom, x);
+        }
+    }
+    liberer_repertoire(&r);
+    return erreur;
+}
+
+int verifier_membre(FILE *fic, repertoire *r, entree_repertoire *e, extraction *x)
+{
+    char nom[500], source[500], *p_nom = nom;
+    entete_membre m;
+    entree_repertoire *s;
+    noeud *alphabet[256], feuilles[256];
+    unsigned int crc;
+    int i, erreur;
+
+    /* un doublon est juste si son en-tête a la taille du répertoire et si sa source, de même taille et même CRC32C,
+       se décode avec ce CRC32C */
+    if (doublon(fic, e, source))
+    {
+        if (fseek(fic, e->position, SEEK_SET) != 0 || membre_doublon(fic) != e->taille ||
+            (s = chercher_source(r, source, e)) == NULL || verifier_membre(fic, r, s, x) != 0)
+        {
+            return -1;
+        }
+        return 1;
+    }
+    if (e->position_table >= 0 && (fseek(fic, e->position_table, SEEK_SET) != 0 || !table_partagee(fic, &x->table_solide)))
+    {
+        return -1;
+    }
+    for (i = 0; i < 256; i++)
+    {
+        alphabet[i] = NULL;
+    }
+    if (fseek(fic, e->position, SEEK_SET) != 0)
+    {
+        return -1;
+    }
+    lire_entete_membre(fic, &m);
+    if (m.type == 'H')
+    {
+        rec_alph_fich(fic, alphabet, feuilles, &p_nom);
+    }
+    else
+    {
+        lecture_nom_fichier(fic, &p_nom);
+    }
+    erreur = decoder_membre(fic, NULL, &m, alphabet, x, &crc) != 0 || fscanf(fic, "\n\n\n") != 0 || crc != e->crc;
+    /* le décodeur d'origine lit un octet d'avance : sa fin de membre n'est pas vérifiée */
+    if (!erreur && m.type != 'H' && ftell(fic) != e->position + e->taille_membre)
+    {
+        erreur = 1;
+    }
+    return erreur ? -1 : 0;
+}
+
+int verifier_membre_suivant(FILE *fic, extraction *x, char *nom, long *taille)
+{
+    char source[500], *p_nom = nom, *p_source = source;
+    entete_membre m;
+    noeud *alphabet[256], feuilles[256];
+    unsigned int crc;
+    int i, c;
+
+    while (table_partagee(fic, &x->table_solide))
+    {
+    }
+    if ((c = fgetc(fic)) == EOF || c == 'I')
+    {
+        return 2;
+    }
+    ungetc(c, fic);
+    for (i = 0; i < 256; i++)
+    {
+        alphabet[i] = NULL;
+    }
+    lire_entete_membre(fic, &m);
+    if (m.type == 'H')
+    {
+        rec_alph_fich(fic, alphabet, feuilles, &p_nom);
+        m.taille = nb_car_total(alphabet);
+    }
+    else
+    {
+        lecture_nom_fichier(fic, &p_nom);
+    }
+    *taille = m.taille;
+    if (m.type == 'L')
+    {
+        lecture_nom_fichier(fic, &p_source);
+        return fscanf(fic, "\n\n\n") != 0 ? -1 : 1;
+    }
+    /* sans répertoire central, il n'y a pas de CRC32C à comparer : seul le décodage est vérifié */
+    return decoder_membre(fic, NULL, &m, alphabet, x, &crc) != 0 || fscanf(fic, "\n\n\n") != 0 ? -1 : 0;
+}
+
+int lister_archive(FILE *fic)
+{
+    repertoire r;
+    long total = 0, total_membres = 0;
+    int i;
+
+    if (lire_repertoire(fic, &r) != 0)
+    {
+        printf("L'archive n'a pas de repertoire central\n");
+        return -1;
+    }
+    printf("%12s %12s %7s %8s  %s\n", "taille", "archive", "taux", "crc32c", "nom");
+    for (i = 0; i < r.nb; i++)
+    {
+        printf("%12ld %12ld %6.1f%% %08x  %s\n", r.entrees[i].taille, r.entrees[i].taille_membre,
+               r.entrees[i].taille > 0 ? 100.0 * r.entrees[i].taille_membre / r.entrees[i].taille : 100.0, r.entrees[i].crc, r.entrees[i].nom);
+        total += r.entrees[i].taille;
+        total_membres += r.entrees[i].taille_membre;
+    }
+    printf("%12ld %12ld %6.1f%% %8s  %d fichiers\n", total, total_membres, total > 0 ? 100.0 * total_membres / total : 100.0, "", r.nb);
+    liberer_repertoire(&r);
+    return 0;
+}
+
+/* membre d'une archive source, pour la fusion */
+typedef struct membre_source
+{
+    int archive, ordre;
+    entree_repertoire *e;
+} membre_source;
+
+static int comparer_membres(const void *a, const void *b)
+{
+    const membre_source *x = (const membre_source *)a, *y = (const membre_source *)b;
+    int c = strcmp(x->e->nom, y->e->nom);
+    return c != 0 ? c : x->ordre - y->ordre;
+}
+
+static int comparer_ordre(const void *a, const void *b)
+{
+    return ((const membre_source *)a)->ordre - ((const membre_source *)b)->ordre;
+}
+
+static int selectionne(char *nom, char **selection, int nb_selection)
+{
+    int i;
+    if (nb_selection == 0)
+    {
+        return 1;
+    }
+    for (i = 0; i < nb_selection; i++)
+    {
+        if (strcmp(selection[i], nom) == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* recopie le membre s de fic à la position courante de fic_dest sous le nom nom : seule la ligne du nom de l'en-tête change,
+   ce qui décale de *decalage octets la suite du membre ; retourne 0 si tout va bien et -1 sinon */
+static int recopier_sous_nom(FILE *fic, entree_repertoire *s, char *nom, FILE *fic_dest, long *decalage)
+{
+    char nom_source[500], *p_nom = nom_source;
+    noeud *alphabet[256], feuilles[256];
+    entete_membre m;
+    long debut_nom, fin_nom;
+    int i;
+
+    for (i = 0; i < 256; i++)
+    {
+        alphabet[i] = NULL;
+    }
+    if (fseek(fic, s->position, SEEK_SET) != 0)
+    {
+        return -1;
+    }
+    lire_entete_membre(fic, &m);
+    if (m.type == 'H')
+    {
+        rec_alph_fich(fic, alphabet, feuilles, &p_nom);
+    }
+    else
+    {
+        lecture_nom_fichier(fic, &p_nom);
+    }
+    fin_nom = ftell(fic);
+    debut_nom = fin_nom - strlen(nom_source) - 1;
+    *decalage = (long)strlen(nom) - (long)strlen(nom_source);
+    return fseek(fic, s->position, SEEK_SET) != 0 || copie_brute(fic, fic_dest, debut_nom - s->position) != 0 ||
+                   fprintf(fic_dest, "%s\n", nom) < 0 || fseek(fic, fin_nom, SEEK_SET) != 0 ||
+                   copie_brute(fic, fic_dest, s->position + s->taille_membre - fin_nom) != 0
+               ? -1
+               : 0;
+}
+
+int fusionner_archives(FILE *fic_dest, char **archives, int nb_archives, char **selection, int nb_selection, repertoire *r)
+{
+    repertoire *sources;
+    membre_source *membres;
+    FILE **fics;
+    entree_repertoire entree, *copie_source, *copie;
+    int i, j, nb = 0, gardes, table_archive = -1, erreur = 0;
+    long table_source = -1, table_dest = -1, decalage;
+    char source[500];
+
+    sources = (repertoire *)calloc(nb_archives, sizeof(repertoire));
+    fics = (FILE **)calloc(nb_archives, sizeof(FILE *));
+    if (sources == NULL || fics == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < nb_archives && !erreur; i++)
+    {
+        if ((fics[i] = fopen(archives[i], "r")) == NULL || lire_repertoire(fics[i], &sources[i]) != 0)
+        {
+            printf("L'archive %s est illisible ou n'a pas de repertoire central\n", archives[i]);
+            erreur = 1;
+        }
+        nb += sources[i].nb;
+    }
+    if ((membres = (membre_source *)malloc((nb > 0 ? nb : 1) * sizeof(membre_source))) == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    nb = 0;
+    for (i = 0; i < nb_archives; i++)
+    {
+        for (j = 0; j < sources[i].nb; j++)
+        {
+            if (selectionne(sources[i].entrees[j].nom, selection, nb_selection))
+            {
+                membres[nb].archive = i;
+                membres[nb].ordre = nb;
+                membres[nb].e = &sources[i].entrees[j];
+                nb++;
+            }
+        }
+    }
+    /* un nom présent plusieurs fois ne garde que sa version la plus récente (la dernière dans l'ordre des archives) */
+    qsort(membres, nb, sizeof(membre_source), comparer_membres);
+    gardes = 0;
+    for (i = 0; i < nb; i++)
+    {
+        if (i + 1 == nb || strcmp(membres[i].e->nom, membres[i + 1].e->nom) != 0)
+        {
+            membres[gardes++] = membres[i];
+        }
+    }
+    qsort(membres, gardes, sizeof(membre_source), comparer_ordre);
+
+    /* les membres sont recopiés octet pour octet ; seul le répertoire est reconstruit */
+    for (i = 0; i < gardes && !erreur; i++)
+    {
+        entree = *membres[i].e;
+        copie = membres[i].e;
+        /* un doublon n'est recopié tel quel que si son fichier source l'a été avant lui ; sinon (source non choisie ou remplacée
+           par une version plus récente), c'est le membre source qui est recopié sous le nom du doublon */
+        if (doublon(fics[membres[i].archive], membres[i].e, source) &&
+            ((copie_source = chercher_entree(r, source)) == NULL || copie_source->crc != membres[i].e->crc || copie_source->taille != membres[i].e->taille))
+        {
+            do
+            {
+                copie = chercher_source(&sources[membres[i].archive], source, copie);
+            } while (copie != NULL && doublon(fics[membres[i].archive], copie, source));
+            if (copie == NULL)
+            {
+                printf("Le fichier %s est un doublon de %s, introuvable dans son archive\n", membres[i].e->nom, source);
+                erreur = 1;
+                break;
+            }
+            entree.position_table = copie->position_table;
+        }
+        entree.index.blocs = NULL;
+        entree.index.nb = entree.index.capacite = 0;
+        /* un membre P a besoin de sa table partagée, recopiée une fois pour les membres consécutifs qui la partagent */
+        if (entree.position_table >= 0)
+        {
+            if (membres[i].archive != table_archive || entree.position_table != table_source)
+            {
+                table_archive = membres[i].archive;
+                table_source = entree.position_table;
+                table_dest = ftell(fic_dest);
+                erreur = fseek(fics[table_archive], table_source, SEEK_SET) != 0 ||
+                         copie_brute(fics[table_archive], fic_dest, 2 + TAILLE_TABLE) != 0;
+            }
+            entree.position_table = table_dest;
+        }
+        entree.position = ftell(fic_dest);
+        decalage = 0;
+        if (copie == membres[i].e)
+        {
+            erreur = erreur || fseek(fics[membres[i].archive], copie->position, SEEK_SET) != 0 ||
+                     copie_brute(fics[membres[i].archive], fic_dest, entree.taille_membre) != 0;
+        }
+        else
+        {
+            erreur = erreur || recopier_sous_nom(fics[membres[i].archive], copie, entree.nom, fic_dest, &decalage) != 0;
+            entree.taille_membre = copie->taille_membre + decalage;
+        }
+        /* l'index des blocs est relatif au début du membre : il ne bouge qu'avec la ligne du nom */
+        for (j = 0; j < copie->index.nb; j++)
+        {
+            indexer_bloc(&entree.index, copie->index.blocs[j].debut, copie->index.blocs[j].position + decalage,
+                         copie->index.blocs[j].position_table < 0 ? -1 : copie->index.blocs[j].position_table + decalage);
+        }
+        ajouter_entree(r, &entree);
+    }
+
+    for (i = 0; i < nb_archives; i++)
+    {
+        liberer_repertoire(&sources[i]);
+        if (fics[i] != NULL)
+        {
+            fclose(fics[i]);
+        }
+    }
+    free(sources);
+    free(fics);
+    free(membres);
+    return erreur ? -1 : 0;
+}
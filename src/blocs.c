@@ -0,0 +1,559 @@
+#include "blocs.h"
+#include "contexte.h"
+
+static void ecrire_entier(unsigned long n, unsigned char *octets)
+{
+    octets[0] = (n >> 24) & 0xff;
+    octets[1] = (n >> 16) & 0xff;
+    octets[2] = (n >> 8) & 0xff;
+    octets[3] = n & 0xff;
+}
+
+static long entier_octets(const unsigned char *octets)
+{
+    return ((long)octets[0] << 24) | ((long)octets[1] << 16) | ((long)octets[2] << 8) | (long)octets[3];
+}
+
+static int lire_entier(FILE *fic, long *n)
+{
+    int i, c;
+    *n = 0;
+    for (i = 0; i < 4; i++)
+    {
+        if ((c = fgetc(fic)) == EOF)
+        {
+            return -1;
+        }
+        *n = (*n << 8) | c;
+    }
+    return 0;
+}
+
+static int lire_crc(FILE *fic, unsigned int *crc)
+{
+    long n;
+    if (lire_entier(fic, &n) != 0)
+    {
+        return -1;
+    }
+    *crc = (unsigned int)n;
+    return 0;
+}
+
+void indexer_bloc(index_blocs *index, long debut, long position, long position_table)
+{
+    if (index->nb == index->capacite)
+    {
+        index->capacite = index->capacite == 0 ? 16 : 2 * index->capacite;
+        index->blocs = (bloc_indexe *)realloc(index->blocs, index->capacite * sizeof(bloc_indexe));
+        if (index->blocs == NULL)
+        {
+            printf("Erreur d'allocation memoire\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    index->blocs[index->nb].debut = debut;
+    index->blocs[index->nb].position = position;
+    index->blocs[index->nb].position_table = position_table;
+    index->nb++;
+}
+
+void liberer_index(index_blocs *index)
+{
+    free(index->blocs);
+    index->blocs = NULL;
+    index->nb = index->capacite = 0;
+}
+
+/* choisit le type du bloc de n octets d'occurences tab et prépare sa table dans nouvelle ;
+   precedente est la table du dernier bloc codé, NULL s'il n'y en a pas */
+static char choix_bloc(long tab[], long n, const table_codes *precedente, table_codes *nouvelle)
+{
+    long long cout_meme = -1, cout_nouveau, borne, meilleur;
+
+    if (precedente != NULL && table_couvre(tab, (unsigned char *)precedente->longueurs))
+    {
+        cout_meme = cout_bits(tab, (unsigned char *)precedente->longueurs);
+    }
+    /* aucune nouvelle table ne fait mieux que l'entropie : si l'ancienne fait au moins aussi bien, inutile de construire l'arbre */
+    borne = (long long)(entropie(tab, n) * n) + 8 * TAILLE_TABLE;
+    if (cout_meme >= 0 && cout_meme <= borne)
+    {
+        meilleur = cout_meme;
+    }
+    else
+    {
+        longueurs_codes(tab, nouvelle->longueurs);
+        cout_nouveau = cout_bits(tab, nouvelle->longueurs) + 8 * TAILLE_TABLE;
+        meilleur = cout_meme >= 0 && cout_meme <= cout_nouveau ? cout_meme : cout_nouveau;
+    }
+    if ((meilleur + 7) / 8 * 100 > n * SEUIL_STOCKAGE)
+    {
+        return BLOC_STOCKE;
+    }
+    return meilleur == cout_meme ? BLOC_MEME_TABLE : BLOC_NOUVELLE_TABLE;
+}
+
+/* bits perdus à coder la fenêtre avec les statistiques du bloc plutôt qu'avec les siennes (entropie croisée - entropie) */
+static double surcout_fenetre(long fenetre[], long n_fenetre, long bloc[], long n_bloc)
+{
+    int i;
+    double p_fenetre, p_bloc, bits = 0;
+
+    for (i = 0; i < 256; i++)
+    {
+        if (fenetre[i] > 0)
+        {
+            p_fenetre = (double)fenetre[i] / n_fenetre;
+            /* un octet absent du bloc garde une petite probabilité */
+            p_bloc = (bloc[i] + 0.5) / (n_bloc + 128.0);
+            bits += fenetre[i] * log2(p_fenetre / p_bloc);
+        }
+    }
+    return bits;
+}
+
+size_t point_de_coupe(const unsigned char *tampon, size_t n, long tab[])
+{
+    long fenetre[256];
+    size_t debut, longueur;
+    int i;
+
+    longueur = n < FENETRE_DECOUPE ? n : FENETRE_DECOUPE;
+    occurence_tampon(tampon, longueur, tab);
+    for (debut = longueur; debut < n; debut += longueur)
+    {
+        longueur = n - debut < FENETRE_DECOUPE ? n - debut : FENETRE_DECOUPE;
+        occurence_tampon(tampon + debut, longueur, fenetre);
+        if (surcout_fenetre(fenetre, longueur, tab, debut) > 8 * (TAILLE_TABLE + TAILLE_EN_TETE_BLOC))
+        {
+            break;
+        }
+        for (i = 0; i < 256; i++)
+        {
+            tab[i] += fenetre[i];
+        }
+    }
+    return debut;
+}
+
+void init_codeur_blocs(codeur_blocs *c)
+{
+    c->precedente = NULL;
+    c->suivante = 0;
+}
+
+size_t preparer_bloc(codeur_blocs *c, long tab[], size_t n, char *type)
+{
+    table_codes *nouvelle = &c->tables[c->suivante];
+
+    *type = choix_bloc(tab, n, c->precedente, nouvelle);
+    if (*type == BLOC_STOCKE)
+    {
+        return TAILLE_EN_TETE_BLOC + n;
+    }
+    /* la nouvelle table devient celle du bloc, l'autre servira à préparer la suivante */
+    if (*type == BLOC_NOUVELLE_TABLE)
+    {
+        construire_table(nouvelle);
+        c->precedente = nouvelle;
+        c->suivante = 1 - c->suivante;
+    }
+    return TAILLE_EN_TETE_BLOC + (*type == BLOC_NOUVELLE_TABLE ? TAILLE_TABLE : 0) +
+           (size_t)((cout_bits(tab, c->precedente->longueurs) + 7) / 8);
+}
+
+size_t ecrire_en_tete_bloc(codeur_blocs *c, const unsigned char *src, size_t n, char type, size_t taille, unsigned char *dst)
+{
+    size_t debut_contenu = TAILLE_EN_TETE_BLOC + (type == BLOC_NOUVELLE_TABLE ? TAILLE_TABLE : 0);
+
+    dst[0] = type;
+    ecrire_entier(n, dst + 1);
+    ecrire_entier(taille - debut_contenu, dst + 5);
+    ecrire_entier(crc32c(0, src, n), dst + 9);
+    if (type == BLOC_NOUVELLE_TABLE)
+    {
+        table_en_octets(c->precedente->longueurs, dst + TAILLE_EN_TETE_BLOC);
+    }
+    return debut_contenu;
+}
+
+unsigned int ecrire_bloc(codeur_blocs *c, const unsigned char *src, size_t n, char type, size_t taille, unsigned char *dst)
+{
+    ecrivain_bits e;
+    size_t debut_contenu = ecrire_en_tete_bloc(c, src, n, type, taille, dst);
+
+    if (type == BLOC_STOCKE)
+    {
+        memcpy(dst + debut_contenu, src, n);
+    }
+    else
+    {
+        /* les codes vont directement à leur place : preparer_bloc en a donné la taille exacte */
+        e.tampon = dst + debut_contenu;
+        e.pos = 0;
+        e.acc = 0;
+        e.nb = 0;
+        coder_tampon(&e, c->precedente, src, n);
+        vider_bits(&e);
+    }
+    return crc_bloc_annonce(dst);
+}
+
+long longueur_bloc(const unsigned char *en_tete)
+{
+    long taille_bloc = entier_octets(en_tete + 1), taille_codee = entier_octets(en_tete + 5);
+
+    switch (en_tete[0])
+    {
+    case BLOC_STOCKE:
+        return taille_codee == taille_bloc ? TAILLE_EN_TETE_BLOC + taille_bloc : -1;
+    case BLOC_NOUVELLE_TABLE:
+    case BLOC_MEME_TABLE:
+        /* un codage ne dépasse jamais LONGUEUR_MAX_CODE bits par octet : au-delà, l'en-tête est corrompu */
+        if (taille_codee > taille_bloc * LONGUEUR_MAX_CODE / 8 + 1)
+        {
+            return -1;
+        }
+        return TAILLE_EN_TETE_BLOC + (en_tete[0] == BLOC_NOUVELLE_TABLE ? TAILLE_TABLE : 0) + taille_codee;
+    default:
+        return -1;
+    }
+}
+
+long taille_bloc_clair(const unsigned char *en_tete)
+{
+    return entier_octets(en_tete + 1);
+}
+
+unsigned int crc_bloc_annonce(const unsigned char *en_tete)
+{
+    return (unsigned int)entier_octets(en_tete + 9);
+}
+
+int decoder_bloc(table_codes *table, int *table_lue, const unsigned char *bloc, unsigned char *dst, unsigned int *crc_bloc)
+{
+    long taille_bloc = entier_octets(bloc + 1), taille_codee = entier_octets(bloc + 5);
+    const unsigned char *code = bloc + TAILLE_EN_TETE_BLOC;
+
+    if (bloc[0] == BLOC_STOCKE)
+    {
+        memcpy(dst, code, taille_bloc);
+    }
+    else
+    {
+        if (bloc[0] == BLOC_NOUVELLE_TABLE)
+        {
+            if (octets_en_table(code, table->longueurs) != 0)
+            {
+                return -1;
+            }
+            construire_table(table);
+            *table_lue = 1;
+            code += TAILLE_TABLE;
+        }
+        if (!*table_lue || decoder_tampon(table, code, taille_codee, dst, taille_bloc) != 0)
+        {
+            return -1;
+        }
+    }
+    *crc_bloc = crc32c(0, dst, taille_bloc);
+    return 0;
+}
+
+/* code au plus longueur octets de lecture en blocs écrits dans ecriture ; debut est la position du 1er octet dans le fichier d'origine
+   et position celle du 1er bloc dans le membre ; retourne le nombre d'octets codés */
+static long coder_blocs(flux *lecture, flux *ecriture, long longueur, long taille_bloc, long debut, long position, unsigned int *crc, index_blocs *index)
+{
+    contexte_huffman *contexte = contexte_du_fil();
+    unsigned char *entree, *sortie;
+    codeur_blocs *c = &contexte->blocs;
+    long tab[256], restant = longueur, position_table = -1;
+    size_t lu, disponible = 0, a_lire, taille;
+    unsigned int crc_bloc;
+    char type;
+
+    /* tampons et codeur du contexte du fil : les membres suivants les reprennent sans rien allouer */
+    preparer_tampons(contexte, taille_bloc, TAILLE_EN_TETE_BLOC + TAILLE_TABLE + taille_bloc * LONGUEUR_MAX_CODE / 8 + 1);
+    entree = contexte->entree;
+    sortie = contexte->sortie;
+    init_codeur_blocs(c);
+    lu = 0;
+    *crc = 0;
+    for (;;)
+    {
+        /* le tampon garde ce qui suit le dernier point de coupe */
+        if (lu > 0 && lu < disponible)
+        {
+            memmove(entree, entree + lu, disponible - lu);
+        }
+        disponible -= lu;
+        a_lire = taille_bloc - disponible < (size_t)restant ? taille_bloc - disponible : (size_t)restant;
+        a_lire = lire_flux(lecture, entree + disponible, a_lire);
+        disponible += a_lire;
+        restant -= a_lire;
+        if (disponible == 0)
+        {
+            break;
+        }
+        lu = point_de_coupe(entree, disponible, tab);
+        taille = preparer_bloc(c, tab, lu, &type);
+        if (type == BLOC_NOUVELLE_TABLE)
+        {
+            position_table = position;
+        }
+        if (index != NULL)
+        {
+            indexer_bloc(index, debut, position, type == BLOC_STOCKE ? -1 : position_table);
+        }
+        debut += lu;
+        /* le contrôle se calcule sur le tampon déjà en mémoire, pendant le codage */
+        crc_bloc = ecrire_bloc(c, entree, lu, type, taille, sortie);
+        *crc = crc32c_combiner(*crc, crc_bloc, lu);
+        ecrire_flux(ecriture, sortie, taille);
+        position += taille;
+    }
+    return longueur - restant;
+}
+
+void compression_blocs(FILE *fic_dest, FILE *fic_depart, long taille, char *chemin, long taille_bloc, unsigned int *crc, index_blocs *index)
+{
+    pipeline p;
+    long position_membre;
+
+    position_membre = ftell(fic_dest);
+    fprintf(fic_dest, "B%ld\n\n%s\n", taille, chemin);
+    /* pendant le codage fic_dest appartient au fil écrivain : les positions des blocs sont comptées par coder_blocs */
+    ouvrir_pipeline(&p, fic_depart, NULL, NULL, fic_dest, taille);
+    coder_blocs(&p.lecture, &p.ecriture, taille, taille_bloc, 0, ftell(fic_dest) - position_membre, crc, index);
+    if (fermer_pipeline(&p) != 0)
+    {
+        printf("Erreur lors de l'ecriture de %s dans l'archive\n", chemin);
+        exit(EXIT_FAILURE);
+    }
+    fputs("\n\n\n", fic_dest);
+}
+
+long segment_blocs(FILE *fic_dest, FILE *fic_depart, long longueur, long taille_bloc, long debut, unsigned int *crc, index_blocs *index)
+{
+    flux lecture, ecriture;
+
+    init_flux(&lecture, fic_depart, NULL);
+    init_flux(&ecriture, fic_dest, NULL);
+    return coder_blocs(&lecture, &ecriture, longueur, taille_bloc, debut, 0, crc, index);
+}
+
+long membre_blocs(FILE *fic)
+{
+    long taille;
+    int c = fgetc(fic);
+    if (c != 'B')
+    {
+        ungetc(c, fic);
+        return -1;
+    }
+    if (fscanf(fic, "%ld", &taille) != 1 || fgetc(fic) != '\n')
+    {
+        printf("erreur de lecture du fichier compressé\n");
+        exit(EXIT_FAILURE);
+    }
+    return taille;
+}
+
+/* ce que le fil lecteur sait d'un membre B : il lit les en-têtes pour s'arrêter juste après le dernier bloc */
+typedef struct lecture_blocs
+{
+    long restant;   /* octets d'origine des blocs dont l'en-tête n'a pas encore été lu */
+    long a_copier;  /* octets du bloc en cours qui restent à lire après son en-tête */
+} lecture_blocs;
+
+static size_t lire_blocs(FILE *fic, unsigned char *tampon, size_t n, void *etat)
+{
+    lecture_blocs *l = (lecture_blocs *)etat;
+    size_t rempli = 0, k;
+    unsigned char *en_tete;
+    long longueur;
+
+    while (rempli < n)
+    {
+        if (l->a_copier == 0)
+        {
+            if (l->restant <= 0 || n - rempli < TAILLE_EN_TETE_BLOC)
+            {
+                break;
+            }
+            en_tete = tampon + rempli;
+            if ((k = fread(en_tete, 1, TAILLE_EN_TETE_BLOC, fic)) != TAILLE_EN_TETE_BLOC)
+            {
+                l->restant = 0;
+                return rempli + k;
+            }
+            rempli += TAILLE_EN_TETE_BLOC;
+            /* en-tête incohérent : le décodeur s'en apercevra, il n'y a plus rien à lire */
+            if ((longueur = longueur_bloc(en_tete)) < 0)
+            {
+                l->restant = 0;
+                continue;
+            }
+            l->a_copier = longueur - TAILLE_EN_TETE_BLOC;
+            l->restant -= taille_bloc_clair(en_tete);
+            continue;
+        }
+        k = n - rempli < (size_t)l->a_copier ? n - rempli : (size_t)l->a_copier;
+        if ((k = fread(tampon + rempli, 1, k, fic)) == 0)
+        {
+            l->restant = l->a_copier = 0;
+            break;
+        }
+        rempli += k;
+        l->a_copier -= k;
+    }
+    return rempli;
+}
+
+int decompression_blocs(FILE *fic_comp, FILE *fic_decom, long taille, unsigned int *crc)
+{
+    contexte_huffman *contexte = contexte_du_fil();
+    table_codes *table = &contexte->table;
+    long longueur, taille_bloc;
+    unsigned int crc_attendu, crc_bloc;
+    int table_lue = 0, erreur = 0;
+    lecture_blocs l;
+    pipeline p;
+
+    /* bloc lu dans l'entrée du contexte, décodé dans sa sortie : elles ne grandissent que pour un bloc plus grand que les précédents */
+    preparer_tampons(contexte, TAILLE_EN_TETE_BLOC, 1);
+    l.restant = taille;
+    l.a_copier = 0;
+    ouvrir_pipeline(&p, fic_comp, lire_blocs, &l, fic_decom, taille);
+    while (taille > 0 && !erreur)
+    {
+        if (lire_flux(&p.lecture, contexte->entree, TAILLE_EN_TETE_BLOC) != TAILLE_EN_TETE_BLOC)
+        {
+            erreur = 1;
+            break;
+        }
+        longueur = longueur_bloc(contexte->entree);
+        taille_bloc = taille_bloc_clair(contexte->entree);
+        crc_attendu = crc_bloc_annonce(contexte->entree);
+        if (longueur < 0 || taille_bloc > taille)
+        {
+            erreur = 1;
+            break;
+        }
+        /* le bloc entier, en-tête compris, est lu d'un coup puis décodé en mémoire */
+        preparer_tampons(contexte, longueur, taille_bloc);
+        if ((long)lire_flux(&p.lecture, contexte->entree + TAILLE_EN_TETE_BLOC, longueur - TAILLE_EN_TETE_BLOC) != longueur - TAILLE_EN_TETE_BLOC ||
+            decoder_bloc(table, &table_lue, contexte->entree, contexte->sortie, &crc_bloc) != 0)
+        {
+            erreur = 1;
+            break;
+        }
+        if (crc_bloc != crc_attendu)
+        {
+            printf("Bloc corrompu (CRC32C %08x au lieu de %08x)\n", crc_bloc, crc_attendu);
+            erreur = 1;
+        }
+        ecrire_flux(&p.ecriture, contexte->sortie, taille_bloc);
+        *crc = crc32c_combiner(*crc, crc_bloc, taille_bloc);
+        taille -= taille_bloc;
+    }
+    if (fermer_pipeline(&p) != 0)
+    {
+        erreur = 1;
+    }
+    return erreur ? -1 : 0;
+}
+
+/* indice du dernier bloc qui commence avant ou à debut */
+static int chercher_bloc(index_blocs *index, long debut)
+{
+    int bas = 0, haut = index->nb - 1, milieu;
+    while (bas < haut)
+    {
+        milieu = (bas + haut + 1) / 2;
+        if (index->blocs[milieu].debut <= debut)
+        {
+            bas = milieu;
+        }
+        else
+        {
+            haut = milieu - 1;
+        }
+    }
+    return bas;
+}
+
+int plage_blocs(FILE *fic, long position_membre, index_blocs *index, long debut, long longueur, FILE *fic_decom)
+{
+    table_codes *table;
+    unsigned char *code = NULL, *clair = NULL;
+    long taille_bloc, taille_codee, table_chargee = -1, decalage, n;
+    unsigned int crc_attendu;
+    int i, type, erreur = 0;
+
+    if (longueur <= 0 || index->nb == 0)
+    {
+        return 0;
+    }
+    if ((table = (table_codes *)malloc(sizeof(table_codes))) == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = chercher_bloc(index, debut); i < index->nb && longueur > 0 && !erreur; i++)
+    {
+        /* un bloc M réutilise la table du dernier bloc N : on ne la relit que si elle change */
+        if (index->blocs[i].position_table >= 0 && index->blocs[i].position_table != table_chargee)
+        {
+            if (fseek(fic, position_membre + index->blocs[i].position_table + TAILLE_EN_TETE_BLOC, SEEK_SET) != 0 ||
+                lire_table(fic, table->longueurs) != 0)
+            {
+                erreur = 1;
+                break;
+            }
+            construire_table(table);
+            table_chargee = index->blocs[i].position_table;
+        }
+        if (fseek(fic, position_membre + index->blocs[i].position, SEEK_SET) != 0 || (type = fgetc(fic)) == EOF ||
+            lire_entier(fic, &taille_bloc) != 0 || lire_entier(fic, &taille_codee) != 0 || lire_crc(fic, &crc_attendu) != 0)
+        {
+            erreur = 1;
+            break;
+        }
+        if (type == BLOC_NOUVELLE_TABLE)
+        {
+            fseek(fic, TAILLE_TABLE, SEEK_CUR);
+        }
+        decalage = debut > index->blocs[i].debut ? debut - index->blocs[i].debut : 0;
+        n = taille_bloc - decalage < longueur ? taille_bloc - decalage : longueur;
+        if (n <= 0)
+        {
+            break;
+        }
+        if (type == BLOC_STOCKE)
+        {
+            erreur = fseek(fic, decalage, SEEK_CUR) != 0 || copie_brute(fic, fic_decom, n) != 0;
+        }
+        else
+        {
+            code = (unsigned char *)realloc(code, taille_codee);
+            clair = (unsigned char *)realloc(clair, taille_bloc);
+            if ((code == NULL && taille_codee > 0) || (clair == NULL && taille_bloc > 0))
+            {
+                printf("Erreur d'allocation memoire\n");
+                exit(EXIT_FAILURE);
+            }
+            /* le bloc est décodé jusqu'à la fin de la plage seulement */
+            erreur = (long)fread(code, 1, taille_codee, fic) != taille_codee ||
+                     decoder_tampon(table, code, taille_codee, clair, decalage + n) != 0 ||
+                     (decalage + n == taille_bloc && crc32c(0, clair, taille_bloc) != crc_attendu) ||
+                     (long)fwrite(clair + decalage, 1, n, fic_decom) != n;
+        }
+        longueur -= n;
+    }
+    free(code);
+    free(clair);
+    free(table);
+    return erreur ? -1 : 0;
+}
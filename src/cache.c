@@ -0,0 +1,114 @@
+#include "cache.h"
+
+int charger_cache(char *chemin, char *destination, cache *c)
+{
+    FILE *fic;
+    char archive[1024];
+    long taille, mtime;
+    struct stat st_archive, st_destination;
+
+    init_repertoire(&c->r);
+    c->fic = NULL;
+    if ((fic = fopen(chemin, "r")) == NULL)
+    {
+        return 0; /* premier passage : pas encore de cache */
+    }
+    if (fscanf(fic, "C%ld %ld\n", &taille, &mtime) != 2 || fgets(archive, sizeof(archive), fic) == NULL)
+    {
+        fclose(fic);
+        return -1;
+    }
+    archive[strcspn(archive, "\n")] = '\0';
+    /* l'archive a été modifiée ou remplacée : les positions du cache ne sont plus sûres */
+    if (stat(archive, &st_archive) != 0 || st_archive.st_size != taille || st_archive.st_mtime != mtime)
+    {
+        printf("Le cache %s ne correspond plus a l'archive %s : il est ignore\n", chemin, archive);
+        fclose(fic);
+        return 0;
+    }
+    /* l'archive en cours d'écriture ne peut pas servir de source */
+    if (stat(destination, &st_destination) == 0 && st_destination.st_dev == st_archive.st_dev && st_destination.st_ino == st_archive.st_ino)
+    {
+        printf("Le cache %s designe l'archive en cours d'ecriture : il est ignore\n", chemin);
+        fclose(fic);
+        return 0;
+    }
+    if (lire_repertoire(fic, &c->r) != 0)
+    {
+        fclose(fic);
+        return -1;
+    }
+    fclose(fic);
+    c->fic = fopen(archive, "r");
+    return 0;
+}
+
+entree_repertoire *chercher_dans_cache(cache *c, entree_repertoire *e)
+{
+    entree_repertoire *trouvee;
+
+    if (c->fic == NULL || e->empreinte == 0 || (trouvee = chercher_entree(&c->r, e->nom)) == NULL)
+    {
+        return NULL;
+    }
+    /* un membre P dépend de la table partagée qui le précède : il n'est pas recopié seul */
+    if (trouvee->taille != e->taille || trouvee->mtime != e->mtime || trouvee->empreinte != e->empreinte || trouvee->position_table >= 0)
+    {
+        return NULL;
+    }
+    return trouvee;
+}
+
+int copier_depuis_cache(cache *c, FILE *fic_dest, entree_repertoire *e)
+{
+    entree_repertoire *trouvee;
+    int i;
+
+    if ((trouvee = chercher_dans_cache(c, e)) == NULL)
+    {
+        return -1;
+    }
+    /* un doublon ne vaut que dans son archive, à la suite de son fichier source */
+    if (fseek(c->fic, trouvee->position, SEEK_SET) != 0 || fgetc(c->fic) == 'L')
+    {
+        return -1;
+    }
+    if (fseek(c->fic, trouvee->position, SEEK_SET) != 0 || copie_brute(c->fic, fic_dest, trouvee->taille_membre) != 0)
+    {
+        printf("Erreur de lecture de l'archive du cache\n");
+        exit(EXIT_FAILURE);
+    }
+    e->taille_membre = trouvee->taille_membre;
+    e->crc = trouvee->crc;
+    e->position_table = -1;
+    /* les positions de l'index sont relatives au membre : elles restent valables */
+    for (i = 0; i < trouvee->index.nb; i++)
+    {
+        indexer_bloc(&e->index, trouvee->index.blocs[i].debut, trouvee->index.blocs[i].position, trouvee->index.blocs[i].position_table);
+    }
+    return 0;
+}
+
+int sauver_cache(char *chemin, char *archive, repertoire *r)
+{
+    FILE *fic;
+    struct stat st;
+
+    if (stat(archive, &st) != 0 || (fic = fopen(chemin, "w")) == NULL)
+    {
+        return -1;
+    }
+    fprintf(fic, "C%ld %ld\n%s\n", (long)st.st_size, (long)st.st_mtime, archive);
+    ecrire_repertoire(fic, r);
+    return fclose(fic) == 0 ? 0 : -1;
+}
+
+void liberer_cache(cache *c)
+{
+    liberer_repertoire(&c->r);
+    if (c->fic != NULL)
+    {
+        fclose(c->fic);
+        c->fic = NULL;
+    }
+}
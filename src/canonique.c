@@ -0,0 +1,451 @@
+#include "canonique.h"
+
+void longueurs_codes(long tab[], unsigned char longueurs[])
+{
+    /* arbre de Huffman construit comme creer_noeud le ferait, mais dans des tableaux : pas d'allocation, utilisable par
+       plusieurs fils et par la bibliothèque. Les feuilles sont les nœuds 0..nb-1, chaque fusion crée le nœud suivant,
+       toujours après ses deux fils */
+    int i, j, nb, taille, max, p1, p2, poids[256], liste[256], pere[2 * 256], profondeur[2 * 256];
+    unsigned char caractere[256];
+    long occ[256], total = 0;
+
+    for (i = 0; i < 256; i++)
+    {
+        occ[i] = tab[i];
+        total += tab[i];
+        longueurs[i] = 0;
+    }
+    /* les poids sont des int : on réduit les occurences en gardant les octets présents */
+    while (total > INT_MAX / 2)
+    {
+        total = 0;
+        for (i = 0; i < 256; i++)
+        {
+            occ[i] = occ[i] > 0 ? (occ[i] >> 1) | 1 : 0;
+            total += occ[i];
+        }
+    }
+
+    do
+    {
+        /* arbre de Huffman sur les seuls octets présents */
+        nb = 0;
+        for (i = 0; i < 256; i++)
+        {
+            if (occ[i] > 0)
+            {
+                caractere[nb] = (unsigned char)i;
+                poids[nb] = (int)occ[i];
+                liste[nb] = nb;
+                nb++;
+            }
+        }
+        if (nb == 0)
+        {
+            return;
+        }
+        /* fusion des deux plus petits poids, dans le même ordre que creer_noeud */
+        for (taille = nb, j = nb; taille > 1; taille--, j++)
+        {
+            deux_plus_petits(poids, taille, &p1, &p2);
+            pere[liste[p1]] = pere[liste[p2]] = j;
+            poids[p1] += poids[p2];
+            liste[p1] = j;
+            for (i = p2; i < taille - 1; i++)
+            {
+                poids[i] = poids[i + 1];
+                liste[i] = liste[i + 1];
+            }
+        }
+        /* la racine est le dernier nœud créé ; un alphabet d'un seul caractère a quand même besoin d'un bit */
+        profondeur[j - 1] = 0;
+        max = 0;
+        for (i = j - 2; i >= 0; i--)
+        {
+            profondeur[i] = profondeur[pere[i]] + 1;
+        }
+        for (i = 0; i < nb; i++)
+        {
+            longueurs[caractere[i]] = (unsigned char)(profondeur[i] > 0 ? profondeur[i] : 1);
+            max = profondeur[i] > max ? profondeur[i] : max;
+        }
+
+        /* trop profond : on aplatit la distribution et on recommence */
+        if (max > LONGUEUR_MAX_CODE)
+        {
+            for (i = 0; i < 256; i++)
+            {
+                occ[i] = occ[i] > 0 ? (occ[i] >> 1) | 1 : 0;
+            }
+        }
+    } while (max > LONGUEUR_MAX_CODE);
+}
+
+void construire_table(table_codes *t)
+{
+    int i, l, nb_longueur[LONGUEUR_MAX_CODE + 1] = {0};
+    unsigned int code = 0, suivant[LONGUEUR_MAX_CODE + 1];
+    unsigned int debut, j;
+
+    for (i = 0; i < 256; i++)
+    {
+        nb_longueur[t->longueurs[i]]++;
+    }
+    nb_longueur[0] = 0;
+    /* premier code de chaque longueur, comme dans DEFLATE */
+    for (l = 1; l <= LONGUEUR_MAX_CODE; l++)
+    {
+        code = (code + nb_longueur[l - 1]) << 1;
+        suivant[l] = code;
+    }
+    memset(t->decodage, 0, sizeof(t->decodage));
+    for (i = 0; i < 256; i++)
+    {
+        l = t->longueurs[i];
+        if (l == 0)
+        {
+            t->codes[i] = 0;
+            continue;
+        }
+        t->codes[i] = suivant[l]++;
+        /* toutes les entrées qui commencent par ce code le désignent */
+        debut = t->codes[i] << (LONGUEUR_MAX_CODE - l);
+        for (j = 0; j < (1u << (LONGUEUR_MAX_CODE - l)); j++)
+        {
+            t->decodage[debut + j] = (unsigned short)((i << 4) | l);
+        }
+    }
+}
+
+long long cout_bits(long tab[], unsigned char longueurs[])
+{
+    int i;
+    long long nb_bits = 0;
+    for (i = 0; i < 256; i++)
+    {
+        nb_bits += (long long)tab[i] * longueurs[i];
+    }
+    return nb_bits;
+}
+
+int table_couvre(long tab[], unsigned char longueurs[])
+{
+    int i;
+    for (i = 0; i < 256; i++)
+    {
+        if (tab[i] > 0 && longueurs[i] == 0)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void table_en_octets(const unsigned char longueurs[], unsigned char octets[])
+{
+    int i;
+    for (i = 0; i < 256; i += 2)
+    {
+        octets[i / 2] = (unsigned char)((longueurs[i] << 4) | longueurs[i + 1]);
+    }
+}
+
+int octets_en_table(const unsigned char octets[], unsigned char longueurs[])
+{
+    int i;
+    long places = 0;
+    for (i = 0; i < 256; i += 2)
+    {
+        longueurs[i] = octets[i / 2] >> 4;
+        longueurs[i + 1] = octets[i / 2] & 15;
+        if (longueurs[i] > LONGUEUR_MAX_CODE || longueurs[i + 1] > LONGUEUR_MAX_CODE)
+        {
+            return -1;
+        }
+        places += (longueurs[i] > 0 ? 1L << (LONGUEUR_MAX_CODE - longueurs[i]) : 0) +
+                  (longueurs[i + 1] > 0 ? 1L << (LONGUEUR_MAX_CODE - longueurs[i + 1]) : 0);
+    }
+    /* trop de codes courts pour un code préfixe : construire_table sortirait de la table de décodage */
+    return places > (1L << LONGUEUR_MAX_CODE) ? -1 : 0;
+}
+
+void ecrire_table(FILE *fic, unsigned char longueurs[])
+{
+    unsigned char octets[TAILLE_TABLE];
+    table_en_octets(longueurs, octets);
+    fwrite(octets, 1, TAILLE_TABLE, fic);
+}
+
+int lire_table(FILE *fic, unsigned char longueurs[])
+{
+    unsigned char octets[TAILLE_TABLE];
+    if (fread(octets, 1, TAILLE_TABLE, fic) != TAILLE_TABLE)
+    {
+        return -1;
+    }
+    return octets_en_table(octets, longueurs);
+}
+
+void coder_tampon(ecrivain_bits *e, const table_codes *t, const unsigned char *src, size_t n)
+{
+    size_t i;
+    unsigned long long acc = e->acc;
+    int nb = e->nb;
+
+    for (i = 0; i < n; i++)
+    {
+        acc = (acc << t->longueurs[src[i]]) | t->codes[src[i]];
+        nb += t->longueurs[src[i]];
+        while (nb >= 8)
+        {
+            nb -= 8;
+            e->tampon[e->pos++] = (unsigned char)(acc >> nb);
+        }
+    }
+    e->acc = acc;
+    e->nb = nb;
+}
+
+void vider_bits(ecrivain_bits *e)
+{
+    if (e->nb > 0)
+    {
+        e->tampon[e->pos++] = (unsigned char)(e->acc << (8 - e->nb));
+        e->nb = 0;
+    }
+}
+
+long long bits_tampon(const table_codes *t, const unsigned char *src, size_t n)
+{
+    size_t i;
+    long long nb_bits = 0;
+    for (i = 0; i < n; i++)
+    {
+        nb_bits += t->longueurs[src[i]];
+    }
+    return nb_bits;
+}
+
+/* une part de coder_parallele : compte ses bits, puis les code à partir du bit debut du tampon commun */
+typedef struct part_codee
+{
+  tache t;                  /* en tête, pour que l'ordonnanceur retrouve la part */
+  const table_codes *table;
+  const unsigned char *src;
+  size_t n;
+  unsigned char *dst;       /* tampon commun */
+  long long nb_bits, debut;
+  size_t fin;               /* octets écrits par la part : [debut / 8, fin[ */
+  unsigned char reste;      /* derniers bits de la part, à leur place dans l'octet fin, à recoudre avec la suivante */
+} part_codee;
+
+static void compter_part(tache *t)
+{
+    part_codee *p = (part_codee *)t;
+    p->nb_bits = bits_tampon(p->table, p->src, p->n);
+}
+
+/* les bits d'avant debut sont laissés à 0 dans le premier octet : celui-ci est à la fois le premier de la part
+   et le dernier de la précédente, qui n'y écrit pas et le recoud après coup */
+static void coder_part(tache *t)
+{
+    part_codee *p = (part_codee *)t;
+    ecrivain_bits e;
+
+    e.tampon = p->dst;
+    e.pos = (size_t)(p->debut / 8);
+    e.acc = 0;
+    e.nb = (int)(p->debut % 8);
+    coder_tampon(&e, p->table, p->src, p->n);
+    p->fin = e.pos;
+    p->reste = (unsigned char)(e.nb > 0 ? e.acc << (8 - e.nb) : 0);
+}
+
+void coder_parallele(ordonnanceur *o, ecrivain_bits *e, const table_codes *t, const unsigned char *src, size_t n)
+{
+    part_codee *parts;
+    tache **taches;
+    long long debut;
+    unsigned char attente;
+    int i, nb = (int)((n + TAILLE_PART - 1) / TAILLE_PART);
+
+    if (o == NULL || nb < 2)
+    {
+        coder_tampon(e, t, src, n);
+        return;
+    }
+    parts = (part_codee *)malloc(nb * sizeof(part_codee));
+    taches = (tache **)malloc(nb * sizeof(tache *));
+    if (parts == NULL || taches == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < nb; i++)
+    {
+        parts[i].table = t;
+        parts[i].src = src + (size_t)i * TAILLE_PART;
+        parts[i].n = i < nb - 1 ? TAILLE_PART : n - (size_t)i * TAILLE_PART;
+        parts[i].dst = e->tampon;
+        parts[i].t.cout = (long)parts[i].n;
+    }
+
+    /* 1er passage : taille exacte de chaque part, d'où la position de son premier bit */
+    for (i = 0; i < nb; i++)
+    {
+        parts[i].t.executer = compter_part;
+        taches[i] = &parts[i].t;
+    }
+    soumettre_taches(o, taches, nb);
+    debut = (long long)e->pos * 8 + e->nb;
+    for (i = 0; i < nb; i++)
+    {
+        attendre_tache(o, &parts[i].t);
+        parts[i].debut = debut;
+        debut += parts[i].nb_bits;
+    }
+
+    /* 2ème passage : chaque part est codée à sa place */
+    for (i = 0; i < nb; i++)
+    {
+        parts[i].t.executer = coder_part;
+        taches[i] = &parts[i].t;
+    }
+    soumettre_taches(o, taches, nb);
+    for (i = 0; i < nb; i++)
+    {
+        attendre_tache(o, &parts[i].t);
+    }
+
+    /* couture, en partant des bits qui attendaient dans e : ils complètent le premier octet de la part suivante,
+       ou s'ajoutent à son reste quand elle n'a fini aucun octet (leurs bits ne se chevauchent pas) */
+    attente = (unsigned char)(e->nb > 0 ? e->acc << (8 - e->nb) : 0);
+    for (i = 0; i < nb; i++)
+    {
+        if (parts[i].fin > (size_t)(parts[i].debut / 8))
+        {
+            e->tampon[parts[i].debut / 8] |= attente;
+            attente = 0;
+        }
+        attente |= parts[i].reste;
+    }
+    e->pos = (size_t)(debut / 8);
+    e->nb = (int)(debut % 8);
+    e->acc = attente >> (8 - e->nb);
+    free(parts);
+    free(taches);
+}
+
+long coder_fichier(FILE *fic_depart, FILE *fic_dest, const table_codes *t, ordonnanceur *o, unsigned char *entree, unsigned char *sortie, unsigned int *crc)
+{
+    ecrivain_bits e = {NULL, 0, 0, 0};
+    size_t lu;
+    long total = 0;
+
+    e.tampon = sortie;
+    *crc = 0;
+    while ((lu = fread(entree, 1, TAILLE_FENETRE, fic_depart)) > 0)
+    {
+        *crc = crc32c(*crc, entree, lu);
+        coder_parallele(o, &e, t, entree, lu);
+        fwrite(sortie, 1, e.pos, fic_dest);
+        total += e.pos;
+        e.pos = 0;
+    }
+    vider_bits(&e);
+    fwrite(sortie, 1, e.pos, fic_dest);
+    return total + e.pos;
+}
+
+int decoder_tampon(const table_codes *t, const unsigned char *src, size_t taille_codee, unsigned char *dst, size_t nb_octets)
+{
+    lecteur_bits l = {src, taille_codee, 0, 0, 0};
+    unsigned int entree_table;
+    size_t i;
+    int longueur;
+
+    for (i = 0; i < nb_octets; i++)
+    {
+        /* complète par des 0 après la fin des données, comme decoder_fichier */
+        while (l.nb < LONGUEUR_MAX_CODE)
+        {
+            l.acc = (l.acc << 8) | (l.pos < l.taille ? l.tampon[l.pos] : 0);
+            l.pos++;
+            l.nb += 8;
+        }
+        entree_table = t->decodage[(l.acc >> (l.nb - LONGUEUR_MAX_CODE)) & ((1u << LONGUEUR_MAX_CODE) - 1)];
+        longueur = entree_table & 15;
+        if (longueur == 0)
+        {
+            return -1;
+        }
+        l.nb -= longueur;
+        dst[i] = (unsigned char)(entree_table >> 4);
+    }
+    return 0;
+}
+
+int decoder_fichier(FILE *fic_comp, FILE *fic_decom, const table_codes *t, long nb_octets, long taille_codee, unsigned int *crc)
+{
+    unsigned char entree[TAILLE_MORCEAU], sortie[TAILLE_MORCEAU];
+    lecteur_bits l = {entree, 0, 0, 0, 0};
+    size_t n = 0, a_lire;
+    unsigned int entree_table;
+    int longueur;
+
+    while (nb_octets > 0)
+    {
+        /* recharge au moins LONGUEUR_MAX_CODE bits, complétés par des 0 après la fin des données */
+        while (l.nb <= 56)
+        {
+            if (l.pos == l.taille)
+            {
+                a_lire = taille_codee < TAILLE_MORCEAU ? (size_t)taille_codee : TAILLE_MORCEAU;
+                if (a_lire == 0 || (l.taille = fread(entree, 1, a_lire, fic_comp)) == 0)
+                {
+                    if (l.nb >= LONGUEUR_MAX_CODE)
+                    {
+                        break;
+                    }
+                    l.acc <<= 8;
+                    l.nb += 8;
+                    l.taille = l.pos = 0;
+                    continue;
+                }
+                taille_codee -= l.taille;
+                l.pos = 0;
+            }
+            l.acc = (l.acc << 8) | entree[l.pos++];
+            l.nb += 8;
+        }
+        entree_table = t->decodage[(l.acc >> (l.nb - LONGUEUR_MAX_CODE)) & ((1u << LONGUEUR_MAX_CODE) - 1)];
+        longueur = entree_table & 15;
+        if (longueur == 0)
+        {
+            return -1; /* aucun code ne commence ainsi : données corrompues */
+        }
+        l.nb -= longueur;
+        sortie[n++] = (unsigned char)(entree_table >> 4);
+        nb_octets--;
+        if (n == TAILLE_MORCEAU)
+        {
+            *crc = crc32c(*crc, sortie, n);
+            if (fic_decom != NULL)
+            {
+                fwrite(sortie, 1, n, fic_decom);
+            }
+            n = 0;
+        }
+    }
+    *crc = crc32c(*crc, sortie, n);
+    if (fic_decom != NULL)
+    {
+        fwrite(sortie, 1, n, fic_decom);
+    }
+    /* consomme ce qui reste des données codées (octet de bourrage) */
+    while (taille_codee > 0 && fgetc(fic_comp) != EOF)
+    {
+        taille_codee--;
+    }
+    return 0;
+}
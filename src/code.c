@@ -51,7 +51,6 @@ void creer_code(noeud *element, int code, int profondeur, noeud *alphabet[])
         element->nbr_bits = profondeur;
         element->codage = code;
         alphabet[(unsigned char)element->caractere] = element;
-        affichage_code(element->nbr_bits, element->codage);
     }
     else
     {
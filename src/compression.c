@@ -25,6 +25,7 @@ void ecriture_code(int nbr_bits, int codage, FILE *fic, int pile[], int *l_pile)
             *l_pile = 0;
         }
     }
+    free(code);
 }
 
 /* ecrire l'entete dans le fichier compresser */
@@ -44,6 +45,66 @@ void en_tete(FILE *fic, noeud *alphabet[], char *nom_fichier)
     fprintf(fic, "\n%s\n", nom_fichier);
 }
 
+/* nombre d'octets écrits par en_tete, calculé sans rien écrire */
+long taille_en_tete(noeud *alphabet[], char *nom_fichier)
+{
+    int i;
+    long taille = snprintf(NULL, 0, "%d\n", compter_lettres_alphabet(alphabet));
+
+    for (i = 0; i < 256; i++)
+    {
+        if (alphabet[i] != NULL)
+        {
+            taille += snprintf(NULL, 0, "%c %d %d %d\n", alphabet[i]->caractere, alphabet[i]->occurence, alphabet[i]->codage, alphabet[i]->nbr_bits);
+        }
+    }
+    return taille + snprintf(NULL, 0, "\n%s\n", nom_fichier);
+}
+
+long long bits_codes(noeud *alphabet[])
+{
+    int i;
+    long long nb_bits = 0;
+
+    for (i = 0; i < 256; i++)
+    {
+        if (alphabet[i] != NULL)
+        {
+            nb_bits += (long long)alphabet[i]->occurence * alphabet[i]->nbr_bits;
+        }
+    }
+    return nb_bits;
+}
+
+/* nombre d'octets écrits par codes_fichier : somme des occurences x longueur du code, arrondie à l'octet */
+long taille_codee(noeud *alphabet[])
+{
+    return (long)((bits_codes(alphabet) + 7) / 8);
+}
+
+int stockage_preferable(noeud *alphabet[], char *nom_fichier)
+{
+    int i;
+    long taille = nb_car_total(alphabet);
+    long compresse = taille_en_tete(alphabet, nom_fichier) + taille_codee(alphabet);
+    long stocke = snprintf(NULL, 0, "S%ld\n\n%s\n", taille, nom_fichier) + taille;
+
+    for (i = 0; i < 256; i++)
+    {
+        /* codage garde les bits en chiffres décimaux dans un int : au-delà il déborde */
+        if (alphabet[i] != NULL && alphabet[i]->nbr_bits > NB_BITS_MAX_CODAGE)
+        {
+            return 1;
+        }
+    }
+    return compresse * 100 > stocke * SEUIL_STOCKAGE;
+}
+
+void en_tete_stocke(FILE *fic, long taille, char *nom_fichier)
+{
+    fprintf(fic, "S%ld\n\n%s\n", taille, nom_fichier);
+}
+
 void codes_fichier(FILE *fic_depart, FILE *fic_dest, noeud *alphabet[])
 {
     int c, i, nb = 0;
@@ -0,0 +1,108 @@
+#include "contexte.h"
+
+static pthread_key_t cle_contexte;
+static pthread_once_t cle_creee = PTHREAD_ONCE_INIT;
+
+contexte_huffman *creer_contexte(void)
+{
+    contexte_huffman *c = (contexte_huffman *)malloc(sizeof(contexte_huffman));
+
+    if (c == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    c->entree = c->sortie = NULL;
+    c->taille_entree = c->taille_sortie = 0;
+    reinitialiser_contexte(c);
+    return c;
+}
+
+void liberer_contexte(contexte_huffman *c)
+{
+    free(c->entree);
+    free(c->sortie);
+    free(c);
+}
+
+void reinitialiser_contexte(contexte_huffman *c)
+{
+    int i;
+
+    for (i = 0; i < 256; i++)
+    {
+        c->occurences[i] = 0;
+        c->alphabet[i] = NULL;
+    }
+    init_codeur_blocs(&c->blocs);
+}
+
+static void detruire_contexte(void *c)
+{
+    liberer_contexte((contexte_huffman *)c);
+}
+
+static void creer_cle(void)
+{
+    if (pthread_key_create(&cle_contexte, detruire_contexte) != 0)
+    {
+        printf("Erreur lors de la creation des contextes\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+contexte_huffman *contexte_du_fil(void)
+{
+    contexte_huffman *c;
+
+    pthread_once(&cle_creee, creer_cle);
+    if ((c = (contexte_huffman *)pthread_getspecific(cle_contexte)) == NULL)
+    {
+        c = creer_contexte();
+        pthread_setspecific(cle_contexte, c);
+    }
+    return c;
+}
+
+static unsigned char *agrandir(unsigned char *tampon, size_t *taille, size_t demande)
+{
+    if (demande <= *taille)
+    {
+        return tampon;
+    }
+    if ((tampon = (unsigned char *)realloc(tampon, demande)) == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    *taille = demande;
+    return tampon;
+}
+
+void preparer_tampons(contexte_huffman *c, size_t taille_entree, size_t taille_sortie)
+{
+    c->entree = agrandir(c->entree, &c->taille_entree, taille_entree);
+    c->sortie = agrandir(c->sortie, &c->taille_sortie, taille_sortie);
+}
+
+void construire_arbre(contexte_huffman *c)
+{
+    int i, taille, nb_noeuds = 256;
+
+    for (i = 0; i < 256; i++)
+    {
+        c->noeuds[i].caractere = (char)i;
+        c->noeuds[i].occurence = c->occurences[i];
+        c->noeuds[i].codage = 0;
+        c->noeuds[i].nbr_bits = 0;
+        c->noeuds[i].f_gauche = NULL;
+        c->noeuds[i].f_droit = NULL;
+        c->arbre[i] = &c->noeuds[i];
+        c->alphabet[i] = NULL;
+    }
+    for (taille = 256; taille > 1; taille--)
+    {
+        nb_noeuds += creer_noeud_dans(c->arbre, taille, &c->noeuds[nb_noeuds]);
+    }
+    creer_code(c->arbre[0], 0, 0, c->alphabet);
+}
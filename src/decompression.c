@@ -1,7 +1,35 @@
 #include "decompression.h"
 
+long membre_stocke(FILE *fic)
+{
+    long taille;
+    int c = fgetc(fic);
+    if (c != 'S')
+    {
+        ungetc(c, fic);
+        return -1;
+    }
+    if (fscanf(fic, "%ld", &taille) != 1 || fgetc(fic) != '\n')
+    {
+        printf("erreur de lecture du fichier compressé\n");
+        exit(EXIT_FAILURE);
+    }
+    return taille;
+}
+
+void lecture_nom_fichier(FILE *fic, char **nom_fichier)
+{
+    fgetc(fic); /* \n */
+    if (fgets(*nom_fichier, 500, fic) == NULL)
+    {
+        printf("erreur de lecture du fichier compressé\n");
+        exit(EXIT_FAILURE);
+    };
+    (*nom_fichier)[strcspn(*nom_fichier, "\n")] = '\0'; /* retire le \n du nom du fichier */
+}
+
 /* decompresser l'entete*/
-void rec_alph_fich(FILE *fic, noeud *alphabet[], char **nom_fichier)
+void rec_alph_fich(FILE *fic, noeud *alphabet[], noeud feuilles[], char **nom_fichier)
 {
     noeud *element;
     int n = 0, nb_lu = 0, i = 0;
@@ -25,7 +53,13 @@ void rec_alph_fich(FILE *fic, noeud *alphabet[], char **nom_fichier)
             }
             else
             {
-                element = creer_st_noeud(c, 0);
+                element = &feuilles[(unsigned char)c];
+                element->caractere = c;
+                element->occurence = 0;
+                element->codage = 0;
+                element->nbr_bits = 0;
+                element->f_gauche = NULL;
+                element->f_droit = NULL;
                 c_courant = c;
                 c_lu = 1;
                 alphabet[(unsigned char)c_courant] = element;
@@ -68,13 +102,7 @@ void rec_alph_fich(FILE *fic, noeud *alphabet[], char **nom_fichier)
             break;
         }
     }
-    fgetc(fic); /* \n */
-    if (fgets(*nom_fichier, 500, fic) == NULL)
-    {
-        printf("erreur de lecture du fichier compressé\n");
-        exit(EXIT_FAILURE);
-    };
-    (*nom_fichier)[strcspn(*nom_fichier, "\n")] = '\0'; /* retire le \n du nom du fichier */
+    lecture_nom_fichier(fic, nom_fichier);
     /* enlève le nom du dossier */
     /*    nom = strchr(*nom_fichier, '/');
         if (nom != NULL)
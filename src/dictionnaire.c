@@ -0,0 +1,153 @@
+#include "dictionnaire.h"
+
+int charger_dictionnaire(char *chemin, dictionnaire *d)
+{
+    FILE *fic;
+    int id;
+
+    memset(d, 0, sizeof(dictionnaire));
+    if ((fic = fopen(chemin, "r")) == NULL)
+    {
+        return 0;
+    }
+    while (fscanf(fic, "D%d", &id) == 1)
+    {
+        if (id < 0 || id >= NB_MAX_TABLES || fgetc(fic) != '\n')
+        {
+            fclose(fic);
+            return -1;
+        }
+        if (d->tables[id] == NULL && (d->tables[id] = (table_codes *)malloc(sizeof(table_codes))) == NULL)
+        {
+            fclose(fic);
+            return -1;
+        }
+        if (lire_table(fic, d->tables[id]->longueurs) != 0)
+        {
+            fclose(fic);
+            return -1;
+        }
+        construire_table(d->tables[id]);
+    }
+    fclose(fic);
+    return 0;
+}
+
+void liberer_dictionnaire(dictionnaire *d)
+{
+    int id;
+    for (id = 0; id < NB_MAX_TABLES; id++)
+    {
+        free(d->tables[id]);
+        d->tables[id] = NULL;
+    }
+}
+
+int sauver_dictionnaire(char *chemin, dictionnaire *d)
+{
+    FILE *fic;
+    int id;
+
+    if ((fic = fopen(chemin, "w")) == NULL)
+    {
+        return -1;
+    }
+    for (id = 0; id < NB_MAX_TABLES; id++)
+    {
+        if (d->tables[id] != NULL)
+        {
+            fprintf(fic, "D%d\n", id);
+            ecrire_table(fic, d->tables[id]->longueurs);
+        }
+    }
+    return fclose(fic);
+}
+
+void entrainer_table(char **liste_fichiers, int nb_fichiers, table_codes *t)
+{
+    int fic, i, tab[256];
+    long total[256];
+    FILE *fic_depart;
+
+    /* chaque octet compte au moins une fois : les entrées futures peuvent contenir des octets absents du corpus */
+    for (i = 0; i < 256; i++)
+    {
+        total[i] = 1;
+    }
+    for (fic = 0; fic < nb_fichiers; fic++)
+    {
+        if ((fic_depart = fopen(liste_fichiers[fic], "r")) == NULL)
+        {
+            printf("Impossible d'ouvrir le fichier %s\n", liste_fichiers[fic]);
+            continue;
+        }
+        occurence(fic_depart, tab);
+        fclose(fic_depart);
+        for (i = 0; i < 256; i++)
+        {
+            total[i] += tab[i];
+        }
+    }
+    longueurs_codes(total, t->longueurs);
+    construire_table(t);
+}
+
+int compression_dictionnaire(FILE *fic_dest, FILE *fic_depart, long taille, char *chemin, table_codes *t, int id, unsigned int *crc)
+{
+    unsigned char *entree, *sortie;
+    ecrivain_bits e = {NULL, 0, 0, 0};
+
+    if (taille > TAILLE_MAX_DICTIONNAIRE)
+    {
+        return -1;
+    }
+    entree = (unsigned char *)malloc(taille + 1);
+    sortie = (unsigned char *)malloc(taille * LONGUEUR_MAX_CODE / 8 + 1);
+    if (entree == NULL || sortie == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    if ((long)fread(entree, 1, taille, fic_depart) != taille)
+    {
+        printf("Impossible d'ouvrir le fichier_depart %s pour lecture \n", chemin);
+        exit(EXIT_FAILURE);
+    }
+    *crc = crc32c(0, entree, taille);
+
+    /* une seule lecture : le fichier est codé en mémoire puis écrit, ou stocké si le codage ne rapporte rien */
+    e.tampon = sortie;
+    coder_tampon(&e, t, entree, taille);
+    vider_bits(&e);
+    if ((long)e.pos * 100 <= taille * SEUIL_STOCKAGE)
+    {
+        fprintf(fic_dest, "R%d %ld %ld\n\n%s\n", id, taille, (long)e.pos, chemin);
+        fwrite(sortie, 1, e.pos, fic_dest);
+    }
+    else
+    {
+        en_tete_stocke(fic_dest, taille, chemin);
+        fwrite(entree, 1, taille, fic_dest);
+    }
+    fputs("\n\n\n", fic_dest);
+    free(entree);
+    free(sortie);
+    return 0;
+}
+
+long membre_dictionnaire(FILE *fic, int *id, long *taille_codee)
+{
+    long taille;
+    int c = fgetc(fic);
+    if (c != 'R')
+    {
+        ungetc(c, fic);
+        return -1;
+    }
+    if (fscanf(fic, "%d %ld %ld", id, &taille, taille_codee) != 3 || fgetc(fic) != '\n')
+    {
+        printf("erreur de lecture du fichier compressé\n");
+        exit(EXIT_FAILURE);
+    }
+    return taille;
+}
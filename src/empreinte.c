@@ -0,0 +1,200 @@
+#define _GNU_SOURCE
+#include "empreinte.h"
+
+#define PREMIER_1 0x9E3779B185EBCA87ULL
+#define PREMIER_2 0xC2B2AE3D27D4EB4FULL
+#define PREMIER_3 0x165667B19E3779F9ULL
+#define PREMIER_4 0x85EBCA77C2B2AE63ULL
+#define PREMIER_5 0x27D4EB2F165667C5ULL
+
+static unsigned long long rotation(unsigned long long x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+/* lectures petit-boutistes, quel que soit le processeur */
+static unsigned long long lire_64(const unsigned char *p)
+{
+    int i;
+    unsigned long long x = 0;
+    for (i = 7; i >= 0; i--)
+    {
+        x = (x << 8) | p[i];
+    }
+    return x;
+}
+
+static unsigned long long lire_32(const unsigned char *p)
+{
+    return (unsigned long long)p[0] | ((unsigned long long)p[1] << 8) | ((unsigned long long)p[2] << 16) | ((unsigned long long)p[3] << 24);
+}
+
+static unsigned long long tour(unsigned long long acc, unsigned long long entree)
+{
+    acc += entree * PREMIER_2;
+    acc = rotation(acc, 31);
+    return acc * PREMIER_1;
+}
+
+static unsigned long long fusion(unsigned long long h, unsigned long long v)
+{
+    h ^= tour(0, v);
+    return h * PREMIER_1 + PREMIER_4;
+}
+
+unsigned long long empreinte_tampon(const unsigned char *tampon, size_t n, unsigned long long graine)
+{
+    const unsigned char *p = tampon, *fin = tampon + n;
+    unsigned long long h, v1, v2, v3, v4;
+
+    if (n >= 32)
+    {
+        /* quatre accumulateurs indépendants sur des bandes de 32 octets */
+        v1 = graine + PREMIER_1 + PREMIER_2;
+        v2 = graine + PREMIER_2;
+        v3 = graine;
+        v4 = graine - PREMIER_1;
+        do
+        {
+            v1 = tour(v1, lire_64(p));
+            v2 = tour(v2, lire_64(p + 8));
+            v3 = tour(v3, lire_64(p + 16));
+            v4 = tour(v4, lire_64(p + 24));
+            p += 32;
+        } while (p + 32 <= fin);
+        h = rotation(v1, 1) + rotation(v2, 7) + rotation(v3, 12) + rotation(v4, 18);
+        h = fusion(h, v1);
+        h = fusion(h, v2);
+        h = fusion(h, v3);
+        h = fusion(h, v4);
+    }
+    else
+    {
+        h = graine + PREMIER_5;
+    }
+    h += n;
+    for (; p + 8 <= fin; p += 8)
+    {
+        h ^= tour(0, lire_64(p));
+        h = rotation(h, 27) * PREMIER_1 + PREMIER_4;
+    }
+    if (p + 4 <= fin)
+    {
+        h ^= lire_32(p) * PREMIER_1;
+        h = rotation(h, 23) * PREMIER_2 + PREMIER_3;
+        p += 4;
+    }
+    for (; p < fin; p++)
+    {
+        h ^= *p * PREMIER_5;
+        h = rotation(h, 11) * PREMIER_1;
+    }
+    /* mélange final */
+    h ^= h >> 33;
+    h *= PREMIER_2;
+    h ^= h >> 29;
+    h *= PREMIER_3;
+    h ^= h >> 32;
+    return h;
+}
+
+unsigned long long empreinte_contenu(const unsigned char *contenu, size_t taille)
+{
+    unsigned long long empreinte = 0;
+    size_t n;
+
+    while (taille > 0)
+    {
+        n = taille < TAILLE_MORCEAU_EMPREINTE ? taille : TAILLE_MORCEAU_EMPREINTE;
+        empreinte = empreinte_tampon(contenu, n, empreinte);
+        contenu += n;
+        taille -= n;
+    }
+    return empreinte;
+}
+
+int empreinte_fichier(char *chemin, unsigned long long *empreinte)
+{
+    unsigned char *tampon;
+    size_t lu;
+    FILE *fic;
+
+    *empreinte = 0;
+    if ((fic = fopen(chemin, "r")) == NULL)
+    {
+        return -1;
+    }
+    if ((tampon = (unsigned char *)malloc(TAILLE_MORCEAU_EMPREINTE)) == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    while ((lu = fread(tampon, 1, TAILLE_MORCEAU_EMPREINTE, fic)) > 0)
+    {
+        *empreinte = empreinte_tampon(tampon, lu, *empreinte);
+    }
+    free(tampon);
+    fclose(fic);
+    return 0;
+}
+
+/* travail partagé par les fils : chacun prend le prochain fichier de la liste */
+typedef struct travail_empreintes
+{
+    char **liste;
+    int nb, suivant;
+    unsigned long long *empreintes;
+    pthread_mutex_t verrou;
+} travail_empreintes;
+
+static void *fil_empreintes(void *arg)
+{
+    travail_empreintes *t = (travail_empreintes *)arg;
+    int i;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&t->verrou);
+        i = t->suivant++;
+        pthread_mutex_unlock(&t->verrou);
+        if (i >= t->nb)
+        {
+            return NULL;
+        }
+        empreinte_fichier(t->liste[i], &t->empreintes[i]);
+    }
+}
+
+void empreintes_fichiers(char **liste, int nb, unsigned long long empreintes[])
+{
+    travail_empreintes t;
+    pthread_t fils[NB_MAX_FILS];
+    int i, nb_fils = nb_fils_disponibles();
+
+    if (nb_fils > nb)
+    {
+        nb_fils = nb;
+    }
+    t.liste = liste;
+    t.nb = nb;
+    t.suivant = 0;
+    t.empreintes = empreintes;
+    pthread_mutex_init(&t.verrou, NULL);
+    for (i = 0; i < nb_fils; i++)
+    {
+        if (pthread_create(&fils[i], NULL, fil_empreintes, &t) != 0)
+        {
+            break;
+        }
+    }
+    /* si aucun fil n'a pu démarrer, le travail se fait ici */
+    if (i == 0)
+    {
+        fil_empreintes(&t);
+    }
+    while (i > 0)
+    {
+        pthread_join(fils[--i], NULL);
+    }
+    pthread_mutex_destroy(&t.verrou);
+}
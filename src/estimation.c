@@ -0,0 +1,108 @@
+#include "estimation.h"
+
+double entropie(long tab[], long total)
+{
+    int i;
+    double p, h = 0;
+
+    if (total == 0)
+    {
+        return 0;
+    }
+    for (i = 0; i < 256; i++)
+    {
+        if (tab[i] > 0)
+        {
+            p = (double)tab[i] / total;
+            h -= p * log2(p);
+        }
+    }
+    return h;
+}
+
+long echantillonnage(FILE *fic, long taille, long tab[], double *ecart)
+{
+    unsigned char tampon[TAILLE_ECHANTILLON];
+    int i, j;
+    long local[256], pas, lu, total = 0;
+    double h, h_min = 8, h_max = 0;
+
+    for (i = 0; i < 256; i++)
+    {
+        tab[i] = 0;
+    }
+    /* petit fichier : autant tout lire */
+    if (taille <= (long)NB_ECHANTILLONS * TAILLE_ECHANTILLON)
+    {
+        while ((lu = fread(tampon, 1, TAILLE_ECHANTILLON, fic)) > 0)
+        {
+            occurence_tampon(tampon, lu, local);
+            for (j = 0; j < 256; j++)
+            {
+                tab[j] += local[j];
+            }
+            total += lu;
+        }
+        *ecart = 0;
+        return total;
+    }
+
+    /* sinon NB_ECHANTILLONS morceaux, le premier au début et le dernier à la fin du fichier */
+    pas = (taille - TAILLE_ECHANTILLON) / (NB_ECHANTILLONS - 1);
+    for (i = 0; i < NB_ECHANTILLONS; i++)
+    {
+        if (fseek(fic, i * pas, SEEK_SET) != 0 || (lu = fread(tampon, 1, TAILLE_ECHANTILLON, fic)) <= 0)
+        {
+            break;
+        }
+        occurence_tampon(tampon, lu, local);
+        for (j = 0; j < 256; j++)
+        {
+            tab[j] += local[j];
+        }
+        total += lu;
+        /* l'écart entre les échantillons dit si le contenu change en cours de fichier */
+        h = entropie(local, lu);
+        h_min = h < h_min ? h : h_min;
+        h_max = h > h_max ? h : h_max;
+    }
+    *ecart = total > 0 ? h_max - h_min : 0;
+    return total;
+}
+
+int estimer_fichier(char *chemin, estimation *e)
+{
+    FILE *fic;
+    struct stat st;
+
+    if (stat(chemin, &st) != 0 || (fic = fopen(chemin, "r")) == NULL)
+    {
+        return -1;
+    }
+    estimer_flux(fic, st.st_size, chemin, e);
+    fclose(fic);
+    return 0;
+}
+
+void estimer_flux(FILE *fic, long taille, char *nom, estimation *e)
+{
+    int i, nb_symboles = 0;
+    long tab[256], echantillon;
+    double ecart;
+
+    e->taille = taille;
+    echantillon = echantillonnage(fic, e->taille, tab, &ecart);
+
+    e->entropie = entropie(tab, echantillon);
+    for (i = 0; i < 256; i++)
+    {
+        if (tab[i] > 0)
+        {
+            nb_symboles++;
+        }
+    }
+    /* borne d'entropie pour le contenu, et une ligne "v o c n" d'une dizaine d'octets par symbole pour l'en-tête */
+    e->taille_estimee = (long)ceil(e->taille * e->entropie / 8) + 10L * nb_symboles + snprintf(NULL, 0, "%d\n\n%s\n", nb_symboles, nom);
+    e->stocker = e->taille_estimee * 100 > (e->taille + snprintf(NULL, 0, "S%ld\n\n%s\n", e->taille, nom)) * SEUIL_STOCKAGE;
+    e->taille_bloc = ecart > ECART_ENTROPIE ? TAILLE_BLOC_PETIT : TAILLE_BLOC_GRAND;
+}
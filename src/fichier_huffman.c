@@ -0,0 +1,160 @@
+#define _GNU_SOURCE /* fopencookie */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "libhuffman.h"
+#include "estimation.h"
+
+/* octets compressés lus ou écrits d'un coup */
+#define TAILLE_TAMPON_FICHIER (64 * 1024)
+
+/* état d'un FILE * ouvert par huff_fopen */
+typedef struct fichier_huffman
+{
+  FILE *fic;                                     /* le fichier compressé */
+  huff_stream flux;
+  void *travail;                                 /* état du codeur ou du décodeur */
+  int ecriture;
+  int fin_fichier;                               /* lecture : fic n'a plus rien à donner */
+  size_t debut, fin;                             /* lecture : octets de tampon pas encore décodés */
+  unsigned char tampon[TAILLE_TAMPON_FICHIER];
+} fichier_huffman;
+
+/* code ce qui attend dans le flux et écrit le résultat dans fic ; retourne le dernier retour de huff_encode, ou -1 si fic refuse */
+static int vider_codeur(fichier_huffman *h, int mode)
+{
+    int r;
+    size_t produit;
+
+    do
+    {
+        h->flux.sortie = h->tampon;
+        h->flux.nb_sortie = TAILLE_TAMPON_FICHIER;
+        r = huff_encode(&h->flux, mode);
+        produit = TAILLE_TAMPON_FICHIER - h->flux.nb_sortie;
+        if (fwrite(h->tampon, 1, produit, h->fic) != produit)
+        {
+            return -1;
+        }
+    } while (h->flux.nb_sortie == 0 || (mode == HUFF_FIN && r != HUFF_FINI));
+    return r;
+}
+
+static ssize_t ecrire_fichier(void *cookie, const char *buf, size_t n)
+{
+    fichier_huffman *h = (fichier_huffman *)cookie;
+
+    h->flux.entree = (const unsigned char *)buf;
+    h->flux.nb_entree = n;
+    return vider_codeur(h, HUFF_CONTINUER) < 0 ? -1 : (ssize_t)n;
+}
+
+static ssize_t lire_fichier(void *cookie, char *buf, size_t n)
+{
+    fichier_huffman *h = (fichier_huffman *)cookie;
+    int r;
+
+    h->flux.sortie = (unsigned char *)buf;
+    h->flux.nb_sortie = n;
+    for (;;)
+    {
+        if (h->debut == h->fin && !h->fin_fichier)
+        {
+            h->debut = 0;
+            h->fin = fread(h->tampon, 1, TAILLE_TAMPON_FICHIER, h->fic);
+            if (h->fin == 0)
+            {
+                if (ferror(h->fic))
+                {
+                    return -1;
+                }
+                h->fin_fichier = 1;
+            }
+        }
+        h->flux.entree = h->tampon + h->debut;
+        h->flux.nb_entree = h->fin - h->debut;
+        r = huff_decode(&h->flux, h->fin_fichier ? HUFF_FIN : HUFF_CONTINUER);
+        h->debut = h->fin - h->flux.nb_entree;
+        if (r < 0)
+        {
+            errno = EIO;
+            return -1;
+        }
+        /* 0 octet décodé n'est retourné qu'à la fin du fichier */
+        if (h->flux.nb_sortie < n || r == HUFF_FINI)
+        {
+            return (ssize_t)(n - h->flux.nb_sortie);
+        }
+    }
+}
+
+static int fermer_fichier(void *cookie)
+{
+    fichier_huffman *h = (fichier_huffman *)cookie;
+    int erreur = 0;
+
+    /* le dernier bloc, partiel, n'a pas encore été codé */
+    if (h->ecriture)
+    {
+        erreur = vider_codeur(h, HUFF_FIN) < 0;
+    }
+    if (fclose(h->fic) != 0)
+    {
+        erreur = 1;
+    }
+    free(h->travail);
+    free(h);
+    return erreur ? -1 : 0;
+}
+
+FILE *huff_fopen(const char *chemin, const char *mode)
+{
+    cookie_io_functions_t fonctions = {NULL, NULL, NULL, fermer_fichier};
+    fichier_huffman *h;
+    size_t taille_travail;
+    FILE *f;
+
+    if (mode[0] != 'r' && mode[0] != 'w' && mode[0] != 'a')
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((h = (fichier_huffman *)malloc(sizeof(fichier_huffman))) == NULL)
+    {
+        return NULL;
+    }
+    h->ecriture = mode[0] != 'r';
+    h->fin_fichier = 0;
+    h->debut = h->fin = 0;
+    /* en écriture, les blocs sont grands : le coût de leur table se répartit sur plus d'octets */
+    taille_travail = h->ecriture ? huff_encoder_size(TAILLE_BLOC_GRAND) : HUFF_TAILLE_DECODEUR;
+    h->travail = malloc(taille_travail);
+    h->fic = fopen(chemin, mode[0] == 'r' ? "rb" : mode[0] == 'w' ? "wb" : "ab");
+    if (h->travail == NULL || h->fic == NULL)
+    {
+        if (h->fic != NULL)
+        {
+            fclose(h->fic);
+        }
+        free(h->travail);
+        free(h);
+        return NULL;
+    }
+    if (h->ecriture)
+    {
+        huff_encoder_init(&h->flux, TAILLE_BLOC_GRAND, h->travail, taille_travail);
+        fonctions.write = ecrire_fichier;
+    }
+    else
+    {
+        huff_decoder_init(&h->flux, h->travail, taille_travail);
+        fonctions.read = lire_fichier;
+    }
+    if ((f = fopencookie(h, h->ecriture ? "w" : "r", fonctions)) == NULL)
+    {
+        fclose(h->fic);
+        free(h->travail);
+        free(h);
+    }
+    return f;
+}
@@ -1542,9 +1542,9 @@ void perform_compression(GraphiqueContext *ctx) {
     SDL_Color blue = {100, 150, 255, 255}; /* Bleu moderne */
     SDL_Color yellow = {255, 255, 100, 255}; /* Jaune moderne */
     FILE *fic_depart, *fic_dest;
-    noeud *alphabet[256] = {NULL};
-    noeud *huffman[256] = {NULL};
-    int i, j;
+    contexte_huffman *contexte = contexte_du_fil();
+    unsigned int crc;
+    int i;
     char archive_path[512];
     long compressed_size = 0;
     
@@ -1658,36 +1658,24 @@ void perform_compression(GraphiqueContext *ctx) {
             continue; /* Passer au fichier suivant */
         }
         
-        /* Réinitialiser l'alphabet */
-        for (j = 0; j < 256; j++) {
-            if (alphabet[j]) {
-                free(alphabet[j]);
-                alphabet[j] = NULL;
-            }
-        }
+        /* Réinitialiser le contexte : l'arbre, l'alphabet et les tampons du fichier précédent resservent */
+        reinitialiser_contexte(contexte);
         
-        /* Analyser le fichier */
-        int c;
-        while ((c = fgetc(fic_depart)) != EOF) {
-            if (alphabet[c] == NULL) {
-                alphabet[c] = creer_st_noeud(c, 1);
-            } else {
-                alphabet[c]->occurence++;
-            }
-        }
+        /* Analyser le fichier et créer les codes */
+        occurence(fic_depart, contexte->occurences);
+        construire_arbre(contexte);
         
-        /* Reconstruire l'arbre Huffman */
-        recreation_huffman(alphabet, huffman);
-        
-        /* Créer les codes */
-        creer_code(huffman[0], 0, 0, alphabet);
-        
-        /* Écrire l'en-tête */
-        en_tete(fic_dest, alphabet, filename);
-        
-        /* Compresser le contenu */
+        /* Écrire l'en-tête puis le contenu, stocké tel quel si le codage ne le réduit pas */
         fseek(fic_depart, 0, SEEK_SET);
-        codes_fichier(fic_depart, fic_dest, alphabet);
+        if (stockage_preferable(contexte->alphabet, filename)) {
+            en_tete_stocke(fic_dest, nb_car_total(contexte->alphabet), filename);
+            copie_brute(fic_depart, fic_dest, nb_car_total(contexte->alphabet));
+        } else {
+            en_tete(fic_dest, contexte->alphabet, filename);
+            table_origine(contexte->alphabet, &contexte->table);
+            preparer_tampons(contexte, TAILLE_FENETRE, TAILLE_SORTIE_FENETRE);
+            coder_fichier(fic_depart, fic_dest, &contexte->table, NULL, contexte->entree, contexte->sortie, &crc);
+        }
         
         fclose(fic_depart);
     }
@@ -1751,22 +1739,7 @@ void perform_compression(GraphiqueContext *ctx) {
         SDL_Delay(16);
     }
     
-    /* Nettoyer l'alphabet seulement (les nœuds huffman sont des références) */
-    for (j = 0; j < 256; j++) {
-        if (alphabet[j]) {
-            free(alphabet[j]);
-            alphabet[j] = NULL;
-        }
-    }
-    
-    /* Ne pas libérer huffman car les nœuds sont des références dans l'arbre */
-    /* L'arbre sera libéré automatiquement quand le programme se termine */
-    
-    /* Réinitialiser le tableau huffman */
-    for (j = 0; j < 256; j++) {
-        huffman[j] = NULL;
-    }
-    
+    /* rien à libérer : les noeuds et les tampons appartiennent au contexte, qui resservira */
     show_progress = 0;
     
     /* Afficher le menu de choix final */
@@ -1820,10 +1793,11 @@ void perform_decompression(GraphiqueContext *ctx, char *archive_name) {
     FILE *fic_comp, *fic_decom;
     noeud *alphabet[256] = {NULL};
     noeud *huffman[256] = {NULL};
+    noeud feuilles[256];
     char nom_fichier[500];
     char *nom_ptr = nom_fichier;
     char output_path[512];
-    long original_size = 0, compressed_size = 0;
+    long original_size = 0, compressed_size = 0, taille_stockee;
     
     if (!ctx || !ctx->renderer) return;
     
@@ -1872,7 +1846,12 @@ void perform_decompression(GraphiqueContext *ctx, char *archive_name) {
     SDL_Delay(500);
     
     /* Lire l'en-tête */
-    rec_alph_fich(fic_comp, alphabet, &nom_ptr);
+    taille_stockee = membre_stocke(fic_comp);
+    if (taille_stockee >= 0) {
+        lecture_nom_fichier(fic_comp, &nom_ptr);
+    } else {
+        rec_alph_fich(fic_comp, alphabet, feuilles, &nom_ptr);
+    }
     
     /* Phase 2: Reconstruction de l'arbre Huffman */
     progress_percent = 40;
@@ -1886,7 +1865,9 @@ void perform_decompression(GraphiqueContext *ctx, char *archive_name) {
     SDL_Delay(500);
     
     /* Reconstruire l'arbre Huffman */
-    recreation_huffman(alphabet, huffman);
+    if (taille_stockee < 0) {
+        recreation_huffman(alphabet, huffman);
+    }
     
     /* Créer le fichier de sortie */
     if (strlen(output_filename) > 0) {
@@ -1933,8 +1914,12 @@ void perform_decompression(GraphiqueContext *ctx, char *archive_name) {
     update_window(ctx);
     SDL_Delay(500);
     
-    /* Décompresser */
-    decompression(fic_comp, fic_decom, huffman[0], alphabet);
+    /* Décompresser (ou recopier un membre stocké) */
+    if (taille_stockee >= 0) {
+        copie_brute(fic_comp, fic_decom, taille_stockee);
+    } else {
+        decompression(fic_comp, fic_decom, huffman[0], alphabet);
+    }
     
     /* Obtenir la taille du fichier original (décompressé) */
     fseek(fic_decom, 0, SEEK_END);
@@ -0,0 +1,146 @@
+#ifndef _ARCHIVE_H_
+#define _ARCHIVE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "types.h"
+#include "occurrences.h"
+#include "compression.h"
+#include "decompression.h"
+#include "canonique.h"
+#include "estimation.h"
+#include "dictionnaire.h"
+#include "blocs.h"
+#include "controle.h"
+#include "repertoire.h"
+#include "cache.h"
+#include "prelecture.h"
+#include "ordonnanceur.h"
+#include "synchronisation.h"
+#include "contexte.h"
+
+/* Archive solide : une seule table partagée par tous les membres qui la suivent
+
+table => T puis \n puis les longueurs des codes sur TAILLE_TABLE octets
+membre => P<taille> <taille codée> puis \n, une ligne vide, le nom d'origine du fichier, le contenu codé et \n\n\n
+
+Doublon : un fichier identique à un fichier déjà archivé n'est pas recompressé
+membre => L<taille> puis \n, une ligne vide, le nom d'origine du fichier, une ligne vide, le nom du fichier identique et \n\n\n
+ */
+
+/* 1ère ligne d'un membre */
+typedef struct entete_membre
+{
+  char type;          /* S (stocké), B (blocs), P (table partagée), R (table du dictionnaire), L (doublon) ou H (en-tête Huffman, encore à lire) */
+  long taille;        /* taille d'origine, sauf pour H */
+  long taille_codee;  /* P et R */
+  int table;          /* R : numéro de la table */
+} entete_membre;
+
+typedef struct options_compression
+{
+  long taille_bloc;                 /* 0 : taille conseillée par l'échantillonnage */
+  int format_origine;               /* 1 : une table par fichier, sans blocs */
+  table_codes *table_dictionnaire;  /* table du dictionnaire pour les petits fichiers, NULL sinon */
+  int id_table;
+  cache *cache;                     /* membres déjà compressés par une exécution précédente, NULL sinon */
+} options_compression;
+
+/* ce qu'il faut pour extraire des membres */
+typedef struct extraction
+{
+  table_codes table_solide;  /* dernière table partagée lue */
+  dictionnaire *dico;        /* tables chargées avec -D, NULL sinon */
+  char *dossier;             /* dossier de destination, NULL pour le dossier courant */
+  char *renommer;            /* nom à donner au prochain membre extrait à la place du sien, NULL sinon */
+  repertoire repertoire;     /* répertoire de l'archive, pour vérifier le CRC32C de chaque membre extrait ; vide s'il n'y en a pas */
+  ordonnanceur *ordonnanceur; /* fils qui décodent en parallèle les membres au format d'origine, NULL pour les décoder ici */
+} extraction;
+
+/* au-delà, un fichier en blocs est découpé en segments de cette taille, codés en parallèle et indépendamment */
+#define TAILLE_SEGMENT (16 * 1024 * 1024)
+
+/* une tâche confiée à l'ordonnanceur : le membre entier d'un fichier, ou un segment des blocs d'un gros fichier */
+typedef struct travail_segment
+{
+  tache t;                    /* en tête, pour que l'ordonnanceur retrouve le travail */
+  fichier_source *f;
+  options_compression *o;
+  long debut, longueur, taille_bloc;
+  char *octets;               /* ce qui a été produit, à recopier dans l'archive */
+  size_t taille;
+  long lu;                    /* octets d'origine codés par le segment */
+  unsigned int crc;
+  index_blocs index;          /* positions comptées depuis le début de octets */
+} travail_segment;
+
+/* ce qui a été confié à l'ordonnanceur pour un fichier */
+typedef struct travail_fichier
+{
+  ordonnanceur *ordonnanceur;
+  travail_segment *segments;  /* NULL : rien n'est fait d'avance, le fichier est compressé par ajouter_fichier */
+  int nb_segments, nb_soumis;
+  int entier;                 /* 1 : segments[0] est le membre complet ; 0 : les segments sont les blocs d'un membre B */
+} travail_fichier;
+
+/* confie à ord le codage des nb fichiers d'un lot, sauf ceux qui seront sans doute des doublons, recopiés du cache ou stockés */
+void planifier_lot(ordonnanceur *ord, fichier_source fichiers[], int nb, options_compression *o, repertoire *r, travail_fichier travaux[]);
+
+/* confie à l'ordonnanceur, dans l'ordre, les fichiers entiers de travaux qui attendent encore, tant que les octets d'origine en
+   cours de codage et pas encore écrits restent sous un plafond ; à rappeler avec les fichiers restants à chaque fichier écrit */
+void avancer_lot(travail_fichier travaux[], int nb);
+
+/* attend la fin des tâches de t et libère ce qu'elles ont produit */
+void liberer_travail(travail_fichier *t);
+
+/* ajoute le fichier f (examiné par lire_lot) à la fin de fic_dest et son entrée au répertoire r, avec ce que t a codé d'avance
+   (t peut être NULL) ; un fichier identique à un membre déjà dans r devient un doublon */
+void ajouter_fichier(FILE *fic_dest, fichier_source *f, travail_fichier *t, options_compression *o, repertoire *r);
+
+/* compresse tous les fichiers de liste_fichiers dans fic_dest avec une seule table et ajoute leurs entrées au répertoire r ;
+   chaque membre est codé en parallèle par les fils de ord */
+void compression_solide(FILE *fic_dest, char **liste_fichiers, int nb_fichiers, ordonnanceur *ord, repertoire *r);
+
+/* si la suite de fic est une table partagée, la lit dans t et retourne 1 ; retourne 0 sinon sans rien consommer */
+int table_partagee(FILE *fic, table_codes *t);
+
+/* si le membre qui commence à la position courante est codé avec la table partagée, lit sa 1ère ligne et retourne sa taille d'origine ;
+   retourne -1 sinon sans rien consommer */
+long membre_partage(FILE *fic, long *taille_codee);
+
+/* lit la 1ère ligne du membre qui commence à la position courante ; pour H rien n'est consommé, l'en-tête se lit avec rec_alph_fich */
+void lire_entete_membre(FILE *fic, entete_membre *m);
+
+/* recopie dans fic_dest, sans les décoder, les membres des nb_archives archives (seulement ceux dont le nom est dans selection
+   si nb_selection > 0) et ajoute leurs entrées à r ; un nom présent plusieurs fois ne garde que sa dernière version ; un doublon
+   dont la source n'est pas recopiée devient une copie du membre source ; retourne 0 si tout va bien et -1 sinon */
+int fusionner_archives(FILE *fic_dest, char **archives, int nb_archives, char **selection, int nb_selection, repertoire *r);
+
+/* écrit dans fic_decom (NULL : nulle part, sinon ouvert en lecture et écriture) le contenu du membre dont l'en-tête vient d'être lu
+   et calcule son CRC32C ; retourne 0 si tout va bien et -1 sinon */
+int decoder_membre(FILE *fic, FILE *fic_decom, entete_membre *m, noeud *alphabet[], extraction *x, unsigned int *crc);
+
+/* extrait le membre qui commence à la position courante de fic ;
+   retourne 0 si un membre a été extrait, 1 à la fin de l'archive (ou au début de son répertoire) et -1 en cas d'erreur */
+int extraire_membre(FILE *fic, extraction *x);
+
+/* extrait le seul membre nom en le cherchant dans le répertoire central ; retourne 0 si tout va bien et -1 sinon */
+int extraire_selection(FILE *fic, char *nom, extraction *x);
+
+/* écrit dans fic_decom les longueur octets du membre nom qui commencent à debut ; un membre en blocs n'est décodé
+   que sur les blocs qui couvrent la plage ; retourne 0 si tout va bien et -1 sinon */
+int extraire_plage(FILE *fic, char *nom, long debut, long longueur, FILE *fic_decom, extraction *x);
+
+/* décode le membre e du répertoire r de fic sans rien écrire et compare son CRC32C à celui du répertoire ;
+   retourne 0 s'il est intact, 1 pour un doublon dont la source décodée a son CRC32C et -1 sinon */
+int verifier_membre(FILE *fic, repertoire *r, entree_repertoire *e, extraction *x);
+
+/* décode vers nulle part le membre qui commence à la position courante de fic, pour une archive lue sans répertoire central ;
+   écrit son nom dans nom (500 octets) et sa taille d'origine dans taille ; retourne 0 s'il se décode, 1 pour un doublon
+   (rien à décoder), 2 à la fin de l'archive et -1 sinon */
+int verifier_membre_suivant(FILE *fic, extraction *x, char *nom, long *taille);
+
+/* affiche le contenu du répertoire central ; retourne 0 si tout va bien et -1 sinon */
+int lister_archive(FILE *fic);
+
+#endif /*_ARCHIVE_H_ */
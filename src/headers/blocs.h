@@ -0,0 +1,109 @@
+#ifndef _BLOCS_H_
+#define _BLOCS_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "occurrences.h"
+#include "compression.h"
+#include "canonique.h"
+#include "estimation.h"
+#include "controle.h"
+#include "pipeline.h"
+
+/* Membre découpé en blocs, chacun avec sa table ou celle du bloc précédent
+
+membre => B<taille> puis \n, une ligne vide, le nom d'origine du fichier, les blocs et \n\n\n
+bloc => type sur 1 octet, taille d'origine, taille codée et CRC32C du contenu d'origine sur 4 octets chacun (poids fort en premier), puis
+- N (nouvelle table) : la table sur TAILLE_TABLE octets puis le contenu codé
+- M (même table que le bloc précédent) : le contenu codé
+- S (stocké) : le contenu tel quel
+ */
+
+#define BLOC_NOUVELLE_TABLE 'N'
+#define BLOC_MEME_TABLE 'M'
+#define BLOC_STOCKE 'S'
+#define TAILLE_EN_TETE_BLOC 13
+/* les blocs sont coupés là où le contenu change : on compare chaque fenêtre de FENETRE_DECOUPE octets au bloc en cours */
+#define FENETRE_DECOUPE 4096
+
+/* index des blocs d'un membre, pour décoder une plage sans lire les blocs qui la précèdent ;
+   les positions sont comptées depuis le début du membre dans l'archive */
+typedef struct bloc_indexe
+{
+  long debut;           /* position du 1er octet du bloc dans le fichier d'origine */
+  long position;        /* en-tête du bloc */
+  long position_table;  /* en-tête du bloc N dont la table sert à ce bloc, -1 pour un bloc stocké */
+} bloc_indexe;
+
+typedef struct index_blocs
+{
+  bloc_indexe *blocs;
+  int nb, capacite;
+} index_blocs;
+
+/* ajoute un bloc à la fin de l'index */
+void indexer_bloc(index_blocs *index, long debut, long position, long position_table);
+
+void liberer_index(index_blocs *index);
+
+/* état d'un codeur de blocs entre deux blocs : la table du dernier bloc codé et celle en préparation */
+typedef struct codeur_blocs
+{
+  table_codes tables[2];
+  table_codes *precedente;  /* table du dernier bloc N, NULL avant le premier */
+  int suivante;             /* indice dans tables de celle en préparation */
+} codeur_blocs;
+
+void init_codeur_blocs(codeur_blocs *c);
+
+/* choisit le type du bloc de n octets dont tab donne les occurences (voir point_de_coupe) et retourne la taille exacte
+   qu'il occupera une fois écrit, en-tête compris */
+size_t preparer_bloc(codeur_blocs *c, long tab[], size_t n, char *type);
+
+/* écrit le bloc des n octets de src préparé par preparer_bloc (type, taille) dans dst, qui doit pouvoir recevoir ces taille
+   octets ; retourne le CRC32C de src */
+unsigned int ecrire_bloc(codeur_blocs *c, const unsigned char *src, size_t n, char type, size_t taille, unsigned char *dst);
+
+/* écrit seulement l'en-tête (et la table d'un bloc N) de ce même bloc, pour un codeur qui produit le contenu par morceaux ;
+   retourne le nombre d'octets écrits, au plus TAILLE_EN_TETE_BLOC + TAILLE_TABLE */
+size_t ecrire_en_tete_bloc(codeur_blocs *c, const unsigned char *src, size_t n, char type, size_t taille, unsigned char *dst);
+
+/* taille totale du bloc dont en_tete (TAILLE_EN_TETE_BLOC octets) est l'en-tête, -1 s'il est incohérent */
+long longueur_bloc(const unsigned char *en_tete);
+
+/* taille d'origine du contenu du bloc et son CRC32C */
+long taille_bloc_clair(const unsigned char *en_tete);
+unsigned int crc_bloc_annonce(const unsigned char *en_tete);
+
+/* décode dans dst le bloc entier (de taille longueur_bloc) rangé dans bloc, avec table, la table du dernier bloc N, que le bloc
+   remplace s'il en a une (table_lue passe alors à 1) ; *crc_bloc reçoit le CRC32C du décodé, à comparer à celui de l'en-tête ;
+   retourne 0 si tout va bien et -1 sinon */
+int decoder_bloc(table_codes *table, int *table_lue, const unsigned char *bloc, unsigned char *dst, unsigned int *crc_bloc);
+
+/* longueur du premier bloc à coder parmi les n octets de tampon : s'arrête avant la première fenêtre dont les statistiques
+   s'éloignent assez de celles du bloc pour qu'une nouvelle table soit rentable ; tab reçoit les occurences du bloc */
+size_t point_de_coupe(const unsigned char *tampon, size_t n, long tab[]);
+
+/* écrit fic_depart (taille octets, archivé sous le nom chemin) dans fic_dest sous forme de membre B en blocs d'au plus taille_bloc octets,
+   calcule le CRC32C de son contenu et remplit index s'il n'est pas NULL */
+void compression_blocs(FILE *fic_dest, FILE *fic_depart, long taille, char *chemin, long taille_bloc, unsigned int *crc, index_blocs *index);
+
+/* code les longueur octets suivants de fic_depart, qui commencent à debut dans le fichier d'origine, en blocs indépendants de ceux
+   qui précèdent, écrits dans fic_dest sans en-tête de membre ; les positions de l'index sont comptées depuis le 1er bloc écrit.
+   Retourne le nombre d'octets codés (moins que longueur si le fichier a raccourci) */
+long segment_blocs(FILE *fic_dest, FILE *fic_depart, long longueur, long taille_bloc, long debut, unsigned int *crc, index_blocs *index);
+
+/* si le membre qui commence à la position courante est en blocs, lit sa 1ère ligne et retourne sa taille d'origine ;
+   retourne -1 sinon sans rien consommer */
+long membre_blocs(FILE *fic);
+
+/* décode les blocs d'un membre B de taille octets vers fic_decom (NULL : nulle part) en vérifiant le CRC32C de chacun,
+   et calcule celui du membre ; retourne 0 si tout va bien et -1 sinon */
+int decompression_blocs(FILE *fic_comp, FILE *fic_decom, long taille, unsigned int *crc);
+
+/* écrit dans fic_decom les longueur octets du membre B commençant à debut, en ne décodant que les blocs qui les contiennent
+   (le CRC32C n'est vérifié que pour les blocs lus en entier) ;
+   position_membre est la position du membre dans fic ; retourne 0 si tout va bien et -1 sinon */
+int plage_blocs(FILE *fic, long position_membre, index_blocs *index, long debut, long longueur, FILE *fic_decom);
+
+#endif /*_BLOCS_H_ */
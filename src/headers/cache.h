@@ -0,0 +1,39 @@
+#ifndef _CACHE_H_
+#define _CACHE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "util.h"
+#include "repertoire.h"
+
+/* Cache des membres déjà compressés : un fichier dont le chemin, la taille, la date et l'empreinte n'ont pas changé
+   est recopié tel quel depuis l'archive précédente au lieu d'être recompressé
+
+cache => C<taille de l'archive> <date de l'archive> puis \n, le chemin de l'archive et \n,
+         puis le répertoire de l'archive tel qu'écrit par ecrire_repertoire
+ */
+
+typedef struct cache
+{
+  repertoire r;  /* membres de l'archive précédente */
+  FILE *fic;     /* archive précédente ouverte en lecture, NULL si le cache est vide ou inutilisable */
+} cache;
+
+/* charge le cache chemin ; un cache absent, périmé (l'archive a changé depuis) ou qui désigne destination est laissé vide ;
+   retourne 0 si tout va bien et -1 si le fichier est illisible */
+int charger_cache(char *chemin, char *destination, cache *c);
+
+/* entrée du cache qui correspond au fichier e->nom (taille, mtime et empreinte déjà remplies), NULL s'il n'y en a pas */
+entree_repertoire *chercher_dans_cache(cache *c, entree_repertoire *e);
+
+/* si le fichier e->nom (taille, mtime et empreinte déjà remplies) est dans le cache, recopie son membre à la position courante de fic_dest
+   et complète e ; retourne 0 si le membre a été recopié et -1 sinon */
+int copier_depuis_cache(cache *c, FILE *fic_dest, entree_repertoire *e);
+
+/* enregistre dans chemin le répertoire r de l'archive, qui doit être fermée ; retourne 0 si tout va bien et -1 sinon */
+int sauver_cache(char *chemin, char *archive, repertoire *r);
+
+void liberer_cache(cache *c);
+
+#endif /*_CACHE_H_ */
@@ -0,0 +1,97 @@
+#ifndef _CANONIQUE_H_
+#define _CANONIQUE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "noeud.h"
+#include "code.h"
+#include "types.h"
+#include "controle.h"
+#include "ordonnanceur.h"
+
+/* codes canoniques : seules les longueurs des codes sont transmises, les codes eux-mêmes s'en déduisent */
+
+/* longueur maximale d'un code, qui fixe aussi la taille de la table de décodage (1 << LONGUEUR_MAX_CODE entrées) */
+#define LONGUEUR_MAX_CODE 12
+/* une table sérialisée tient sur 128 octets : deux longueurs de 4 bits par octet */
+#define TAILLE_TABLE 128
+/* taille des morceaux lus et codés d'un coup */
+#define TAILLE_MORCEAU 65536
+/* coder_parallele : part d'un tampon confiée à un fil, et quantité lue d'un coup par coder_fichier */
+#define TAILLE_PART (256 * 1024)
+#define TAILLE_FENETRE (16 * TAILLE_PART)
+
+typedef struct table_codes
+{
+  unsigned char longueurs[256];                      /* 0 si l'octet n'a pas de code */
+  unsigned int codes[256];
+  unsigned short decodage[1 << LONGUEUR_MAX_CODE];   /* (octet << 4) | longueur, indexé par les LONGUEUR_MAX_CODE prochains bits */
+} table_codes;
+
+typedef struct ecrivain_bits
+{
+  unsigned char *tampon;
+  size_t pos;
+  unsigned long long acc;  /* bits en attente, alignés à droite */
+  int nb;                  /* nombre de bits en attente (< 8 entre deux appels) */
+} ecrivain_bits;
+
+typedef struct lecteur_bits
+{
+  const unsigned char *tampon;
+  size_t taille, pos;
+  unsigned long long acc;
+  int nb;
+} lecteur_bits;
+
+/* calcule les longueurs des codes de Huffman à partir des occurences, en les limitant à LONGUEUR_MAX_CODE bits */
+void longueurs_codes(long tab[], unsigned char longueurs[]);
+
+/* complète t (codes et table de décodage) à partir de t->longueurs */
+void construire_table(table_codes *t);
+
+/* nombre exact de bits nécessaires pour coder les occurences tab avec les longueurs données */
+long long cout_bits(long tab[], unsigned char longueurs[]);
+
+/* retourne 1 si chaque octet présent dans tab a un code dans longueurs */
+int table_couvre(long tab[], unsigned char longueurs[]);
+
+/* écrit / lit les longueurs sur TAILLE_TABLE octets ; lire_table retourne 0 si tout va bien et -1 sinon */
+void ecrire_table(FILE *fic, unsigned char longueurs[]);
+int lire_table(FILE *fic, unsigned char longueurs[]);
+
+/* mêmes conversions en mémoire ; octets_en_table retourne 0 si tout va bien et -1 sinon */
+void table_en_octets(const unsigned char longueurs[], unsigned char octets[]);
+int octets_en_table(const unsigned char octets[], unsigned char longueurs[]);
+
+/* ajoute les codes des n octets de src au tampon de e, qui doit pouvoir recevoir n * LONGUEUR_MAX_CODE / 8 + 1 octets */
+void coder_tampon(ecrivain_bits *e, const table_codes *t, const unsigned char *src, size_t n);
+
+/* complète le dernier octet par des 0 */
+void vider_bits(ecrivain_bits *e);
+
+/* nombre exact de bits des codes des n octets de src */
+long long bits_tampon(const table_codes *t, const unsigned char *src, size_t n);
+
+/* comme coder_tampon, mais le tampon est découpé en parts codées en même temps par les fils de o (NULL : ici) :
+   la taille en bits de chaque part donne sa position exacte, chaque fil écrit directement à sa place
+   et seuls les octets partagés entre deux parts sont recousus à la fin */
+void coder_parallele(ordonnanceur *o, ecrivain_bits *e, const table_codes *t, const unsigned char *src, size_t n);
+
+/* taille des tampons d'entrée et de sortie de coder_fichier */
+#define TAILLE_SORTIE_FENETRE (TAILLE_FENETRE * LONGUEUR_MAX_CODE / 8 + 1)
+
+/* code tout fic_depart vers fic_dest avec les fils de o (NULL : aucun) et calcule le CRC32C de ce qui a été lu, par fenêtres
+   lues dans entree (TAILLE_FENETRE octets) et codées dans sortie (TAILLE_SORTIE_FENETRE octets) ; retourne le nombre
+   d'octets écrits */
+long coder_fichier(FILE *fic_depart, FILE *fic_dest, const table_codes *t, ordonnanceur *o, unsigned char *entree, unsigned char *sortie, unsigned int *crc);
+
+/* décode nb_octets octets dans dst depuis les taille_codee octets de src ; retourne 0 si tout va bien et -1 sinon */
+int decoder_tampon(const table_codes *t, const unsigned char *src, size_t taille_codee, unsigned char *dst, size_t nb_octets);
+
+/* décode nb_octets octets depuis les taille_codee octets suivants de fic_comp vers fic_decom (NULL : nulle part) en poursuivant
+   le CRC32C *crc ; retourne 0 si tout va bien et -1 sinon */
+int decoder_fichier(FILE *fic_comp, FILE *fic_decom, const table_codes *t, long nb_octets, long taille_codee, unsigned int *crc);
+
+#endif /*_CANONIQUE_H_ */
@@ -7,6 +7,11 @@
 #include "util.h"
 #include "code.h"
 
+/* un membre n'est compressé que s'il fait moins de SEUIL_STOCKAGE % de sa version stockée */
+#define SEUIL_STOCKAGE 98
+/* plus long code que le champ codage (chiffres binaires écrits en décimal dans un int) peut contenir */
+#define NB_BITS_MAX_CODAGE 10
+
 /* permet d'écrire le code dans un fichier avec un système de pile */
 void ecriture_code(int nbr_bits, int codage, FILE *fic, int pile[], int *l_pile);
 
@@ -22,6 +27,25 @@ void ecriture_code(int nbr_bits, int codage, FILE *fic, int pile[], int *l_pile)
  */
 void en_tete(FILE *fic, noeud *alphabet[], char *nom_fichier);
 
+/* nombre exact d'octets de l'en-tête écrit par en_tete */
+long taille_en_tete(noeud *alphabet[], char *nom_fichier);
+
+/* nombre exact de bits du contenu codé par codes_fichier, avant le bourrage du dernier octet */
+long long bits_codes(noeud *alphabet[]);
+
+/* nombre exact d'octets du contenu codé par codes_fichier, calculé à partir des occurences et des longueurs de code */
+long taille_codee(noeud *alphabet[]);
+
+/* retourne 1 si le fichier décrit par alphabet doit être stocké tel quel plutôt que compressé, 0 sinon */
+int stockage_preferable(noeud *alphabet[], char *nom_fichier);
+
+/* en-tête d'un membre stocké tel quel :
+1ère ligne => S suivi de la taille du contenu en octets
+2ème ligne => vide
+3ème ligne => nom d'origine du fichier
+ */
+void en_tete_stocke(FILE *fic, long taille, char *nom_fichier);
+
 /* fonction écrit dans fic_dest le contenu codé de fic_depart */
 void codes_fichier(FILE *fic_depart, FILE *fic_dest, noeud *alphabet[]);
 
@@ -0,0 +1,49 @@
+#ifndef _CONTEXTE_H_
+#define _CONTEXTE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "types.h"
+#include "noeud.h"
+#include "code.h"
+#include "canonique.h"
+#include "blocs.h"
+
+/* Contexte de codage réutilisable
+
+Un contexte possède tout ce que le codage d'un fichier demande : occurences, noeuds de l'arbre de Huffman, alphabet, table
+de codes, codeur de blocs et tampons d'entrée-sortie. Il est alloué une fois par fil et sert à tous les fichiers que ce fil
+code ou décode : reinitialiser_contexte le remet à zéro sans rien allouer, et les tampons ne font que grandir. Une fois les
+tampons à leur taille, coder d'autres fichiers n'alloue plus rien. Un contexte ne sert qu'à un fichier à la fois.
+ */
+
+typedef struct contexte_huffman
+{
+  int occurences[256];
+  noeud noeuds[2 * 256 - 1];   /* les feuilles (noeuds[i] pour l'octet i) puis les noeuds créés par creer_noeud_dans */
+  noeud *arbre[256];           /* tableau de travail de l'arbre de Huffman, dont arbre[0] est la racine une fois construit */
+  noeud *alphabet[256];        /* feuille de chaque octet présent, NULL pour les autres */
+  table_codes table;
+  codeur_blocs blocs;
+  unsigned char *entree, *sortie;
+  size_t taille_entree, taille_sortie;
+} contexte_huffman;
+
+contexte_huffman *creer_contexte(void);
+void liberer_contexte(contexte_huffman *c);
+
+/* remet à zéro les occurences, l'alphabet et le codeur de blocs ; garde les tampons */
+void reinitialiser_contexte(contexte_huffman *c);
+
+/* contexte du fil appelant, créé à sa première utilisation et libéré quand le fil se termine */
+contexte_huffman *contexte_du_fil(void);
+
+/* agrandit au besoin les tampons à au moins taille_entree et taille_sortie octets, en gardant leur contenu */
+void preparer_tampons(contexte_huffman *c, size_t taille_entree, size_t taille_sortie);
+
+/* arbre de Huffman des occurences du contexte, dans ses noeuds, puis codes de l'alphabet : le même résultat que creer_noeud
+   et creer_code sur des noeuds alloués un par un */
+void construire_arbre(contexte_huffman *c);
+
+#endif /*_CONTEXTE_H_ */
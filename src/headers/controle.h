@@ -0,0 +1,21 @@
+#ifndef _CONTROLE_H_
+#define _CONTROLE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+/* CRC32C (polynôme de Castagnoli) : crc32c(0, ...) démarre un calcul, crc32c(crc, ...) le poursuit sur les octets suivants ;
+   utilise l'instruction crc32 du processeur (SSE4.2 ou ARMv8) quand elle existe, une table sinon */
+unsigned int crc32c(unsigned int crc, const unsigned char *tampon, size_t n);
+
+/* CRC32C de la concaténation de A (crc1) et de B (crc2, n2 octets), sans relire les données */
+unsigned int crc32c_combiner(unsigned int crc1, unsigned int crc2, long n2);
+
+/* CRC32C du contenu de fic à partir de sa position courante jusqu'à la fin */
+unsigned int crc32c_fichier(FILE *fic);
+
+#endif /*_CONTROLE_H_ */
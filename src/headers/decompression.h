@@ -8,8 +8,14 @@
 #include "util.h"
 #include "code.h"
 
-/* lecture de l'en-tête pour reconnaître l'alphabet du fichier */
-void rec_alph_fich(FILE *fic, noeud *alphabet[], char **nom_fichier);
+/* si le membre qui commence à la position courante est stocké tel quel, lit sa 1ère ligne et retourne sa taille ; retourne -1 sinon sans rien consommer */
+long membre_stocke(FILE *fic);
+
+/* lecture de la ligne vide et du nom d'origine qui terminent l'en-tête */
+void lecture_nom_fichier(FILE *fic, char **nom_fichier);
+
+/* lecture de l'en-tête pour reconnaître l'alphabet du fichier ; la feuille de l'octet i est rangée dans feuilles[i] */
+void rec_alph_fich(FILE *fic, noeud *alphabet[], noeud feuilles[], char **nom_fichier);
 
 void recreation_huffman(noeud *alphabet[], noeud *huffman[]);
 
@@ -0,0 +1,47 @@
+#ifndef _DICTIONNAIRE_H_
+#define _DICTIONNAIRE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "occurrences.h"
+#include "compression.h"
+#include "canonique.h"
+#include "controle.h"
+
+/* Dictionnaire : tables pré-calculées sur un corpus, référencées par leur numéro au lieu d'être écrites dans l'archive
+
+fichier dictionnaire => pour chaque table, D<numéro> puis \n puis les longueurs des codes sur TAILLE_TABLE octets
+membre => R<numéro> <taille> <taille codée> puis \n, une ligne vide, le nom d'origine du fichier, le contenu codé et \n\n\n
+ */
+
+#define NB_MAX_TABLES 256
+/* au-delà, un fichier a intérêt à avoir sa propre table : il est compressé normalement */
+#define TAILLE_MAX_DICTIONNAIRE (1024 * 1024)
+
+typedef struct dictionnaire
+{
+  table_codes *tables[NB_MAX_TABLES]; /* NULL si le numéro n'est pas utilisé */
+} dictionnaire;
+
+/* charge les tables du fichier chemin dans d (vide si le fichier n'existe pas) ; retourne 0 si tout va bien et -1 sinon */
+int charger_dictionnaire(char *chemin, dictionnaire *d);
+
+/* libère les tables de d */
+void liberer_dictionnaire(dictionnaire *d);
+
+/* écrit toutes les tables de d dans le fichier chemin ; retourne 0 si tout va bien et -1 sinon */
+int sauver_dictionnaire(char *chemin, dictionnaire *d);
+
+/* construit une table à partir des occurences cumulées des fichiers du corpus ; chaque octet y reçoit un code */
+void entrainer_table(char **liste_fichiers, int nb_fichiers, table_codes *t);
+
+/* écrit le fichier fic_depart (taille octets, archivé sous le nom chemin) dans fic_dest codé avec la table numéro id, sans passage préalable
+   sur ses occurences, et calcule le CRC32C de son contenu ; retourne -1 si le fichier est trop grand pour en profiter, 0 sinon */
+int compression_dictionnaire(FILE *fic_dest, FILE *fic_depart, long taille, char *chemin, table_codes *t, int id, unsigned int *crc);
+
+/* si le membre qui commence à la position courante est codé avec une table du dictionnaire, lit sa 1ère ligne et retourne sa taille d'origine ;
+   retourne -1 sinon sans rien consommer */
+long membre_dictionnaire(FILE *fic, int *id, long *taille_codee);
+
+#endif /*_DICTIONNAIRE_H_ */
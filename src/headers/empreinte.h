@@ -0,0 +1,27 @@
+#ifndef _EMPREINTE_H_
+#define _EMPREINTE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "util.h"
+
+/* Empreinte rapide (non cryptographique) du contenu des fichiers, pour reconnaître un contenu déjà compressé */
+
+/* un fichier est haché par morceaux de TAILLE_MORCEAU_EMPREINTE octets, chaque morceau ayant pour graine l'empreinte du précédent */
+#define TAILLE_MORCEAU_EMPREINTE (1 << 20)
+
+/* XXH64 des n octets de tampon avec la graine donnée */
+unsigned long long empreinte_tampon(const unsigned char *tampon, size_t n, unsigned long long graine);
+
+/* empreinte d'un contenu déjà en mémoire, identique à celle du fichier qui le contient */
+unsigned long long empreinte_contenu(const unsigned char *contenu, size_t taille);
+
+/* empreinte du fichier chemin ; retourne 0 si tout va bien et -1 s'il ne peut pas être lu */
+int empreinte_fichier(char *chemin, unsigned long long *empreinte);
+
+/* empreintes des nb fichiers de liste, calculées en parallèle ; 0 pour un fichier illisible */
+void empreintes_fichiers(char **liste, int nb, unsigned long long empreintes[]);
+
+#endif /*_EMPREINTE_H_ */
@@ -0,0 +1,42 @@
+#ifndef _ESTIMATION_H_
+#define _ESTIMATION_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <sys/stat.h>
+#include "occurrences.h"
+#include "compression.h"
+
+/* nombre de morceaux lus et taille de chacun : au-delà de NB_ECHANTILLONS x TAILLE_ECHANTILLON octets le fichier n'est pas lu en entier */
+#define NB_ECHANTILLONS 8
+#define TAILLE_ECHANTILLON 4096
+
+/* tailles de bloc conseillées selon que le contenu est homogène ou non */
+#define TAILLE_BLOC_PETIT (64 * 1024)
+#define TAILLE_BLOC_GRAND (1024 * 1024)
+/* écart d'entropie (bits par octet) entre deux échantillons à partir duquel le contenu est jugé hétérogène */
+#define ECART_ENTROPIE 1.0
+
+typedef struct estimation
+{
+  long taille;          /* taille réelle du fichier */
+  long taille_estimee;  /* taille prédite du membre compressé */
+  double entropie;      /* entropie d'ordre 0 des échantillons, en bits par octet */
+  int stocker;          /* 1 si le fichier devrait être stocké tel quel */
+  long taille_bloc;     /* taille de bloc conseillée */
+} estimation;
+
+/* entropie d'ordre 0 (bits par octet) d'un tableau d'occurences de total octets */
+double entropie(long tab[], long total);
+
+/* lit quelques morceaux régulièrement espacés de fic (de taille octets) et remplit tab avec leurs occurences ;
+   retourne le nombre d'octets lus. Laisse fic en fin de lecture, il faut le rembobiner avant usage */
+long echantillonnage(FILE *fic, long taille, long tab[], double *ecart);
+
+/* prédit la taille compressée de fic et décide s'il vaut la peine de le compresser ; retourne 0 si tout va bien et -1 sinon */
+int estimer_fichier(char *chemin, estimation *e);
+
+/* même chose pour fic déjà ouvert, de taille octets, archivé sous le nom nom ; laisse fic en fin de lecture */
+void estimer_flux(FILE *fic, long taille, char *nom, estimation *e);
+
+#endif /*_ESTIMATION_H_ */
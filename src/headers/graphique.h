@@ -17,6 +17,8 @@
 #include "code.h"
 #include "compression.h"
 #include "decompression.h"
+#include "contexte.h"
+#include "synchronisation.h"
 /* Types pour le sélecteur de fichiers */
 typedef enum {
     FS_MODE_OPEN,       /* Ouverture de fichier(s) */
@@ -0,0 +1,112 @@
+#ifndef _LIBHUFFMAN_H_
+#define _LIBHUFFMAN_H_
+#include <stddef.h>
+#include <stdio.h>
+
+/* libhuffman : compression de Huffman d'un tampon vers un autre, sans fichier
+
+Le résultat est la suite de blocs d'un membre B d'archive (voir blocs.h), sans l'en-tête du membre : chaque bloc a sa table
+ou celle du précédent, ou est stocké, et porte le CRC32C de son contenu.
+
+Hormis huff_fopen, aucune fonction n'alloue de mémoire ni ne modifie de variable globale : l'appelant fournit une mémoire de travail d'au moins
+HUFF_TAILLE_TRAVAIL octets, alignée comme le serait un pointeur. Des appels simultanés sont sûrs tant que chacun a sa propre
+mémoire de travail.
+ */
+
+/* seules ces fonctions sont exportées par libhuffman.so */
+#if defined(__GNUC__)
+#define HUFF_API __attribute__((visibility("default")))
+#else
+#define HUFF_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* taille de la mémoire de travail demandée par huff_compress et huff_decompress */
+#define HUFF_TAILLE_TRAVAIL (24 * 1024)
+
+/* valeurs de retour négatives */
+#define HUFF_ERREUR_PLACE (-1)    /* dst est trop petit */
+#define HUFF_ERREUR_DONNEES (-2)  /* src n'est pas une suite de blocs valide (ou un CRC32C ne correspond pas) */
+#define HUFF_ERREUR_TRAVAIL (-3)  /* mémoire de travail absente, trop petite ou mal alignée */
+
+/* taille maximale du résultat de huff_compress pour n octets */
+HUFF_API size_t huff_compress_bound(size_t n);
+
+/* compresse les n octets de src dans dst (capacite octets) ; retourne la taille du résultat ou une erreur HUFF_ERREUR_* */
+HUFF_API long huff_compress(const void *src, size_t n, void *dst, size_t capacite, void *travail, size_t taille_travail);
+
+/* taille d'origine des données compressées src (n octets), lue dans les en-têtes des blocs sans rien décoder ;
+   retourne HUFF_ERREUR_DONNEES si src est tronqué ou incohérent */
+HUFF_API long huff_decompressed_size(const void *src, size_t n);
+
+/* décompresse les n octets de src dans dst (capacite octets) en vérifiant le CRC32C de chaque bloc ;
+   retourne la taille d'origine ou une erreur HUFF_ERREUR_* */
+HUFF_API long huff_decompress(const void *src, size_t n, void *dst, size_t capacite, void *travail, size_t taille_travail);
+
+/* Flux : compression et décompression par morceaux, pour une boucle d'événements
+
+L'appelant donne des morceaux d'entrée et de sortie de n'importe quelle taille dans un huff_stream, puis appelle huff_encode ou
+huff_decode, qui avancent entree et sortie autant qu'ils le peuvent sans jamais attendre : ce qui reste de nb_entree n'a pas
+encore été lu, et une sortie remplie (nb_sortie à 0) doit être vidée avant de rappeler. Entre deux appels, l'état du flux
+(bloc en cours, bits pas encore écrits ou pas encore décodés) reste dans la mémoire de travail donnée à l'initialisation,
+qui doit vivre aussi longtemps que le flux. Le résultat est le même que celui de huff_compress, à la découpe des blocs près.
+ */
+typedef struct huff_stream
+{
+  const unsigned char *entree;       /* prochain octet à lire */
+  size_t nb_entree;                  /* octets disponibles à entree */
+  unsigned char *sortie;             /* prochain octet à écrire */
+  size_t nb_sortie;                  /* place libre à sortie */
+  unsigned long long total_entree;   /* octets lus et écrits depuis l'initialisation */
+  unsigned long long total_sortie;
+  void *etat;                        /* état interne, dans la mémoire de travail */
+} huff_stream;
+
+/* mode des appels : continuer, vider (tout ce qui a été lu est écrit, en terminant le bloc en cours), finir le flux */
+#define HUFF_CONTINUER 0
+#define HUFF_VIDER 1
+#define HUFF_FIN 2
+
+/* valeurs de retour positives, en plus des erreurs */
+#define HUFF_OK 0     /* le flux attend de l'entrée ou de la place en sortie */
+#define HUFF_FINI 1   /* mode HUFF_FIN : tout a été écrit (codeur) ou le flux s'arrête proprement entre deux blocs (décodeur) */
+
+/* taille de bloc du codeur quand l'appelant n'en choisit pas */
+#define HUFF_BLOC_FLUX (64 * 1024)
+
+/* mémoire de travail du décodeur */
+#define HUFF_TAILLE_DECODEUR (16 * 1024)
+
+/* mémoire de travail du codeur pour des blocs d'au plus taille_bloc octets (0 : HUFF_BLOC_FLUX) */
+HUFF_API size_t huff_encoder_size(size_t taille_bloc);
+
+/* prépare f pour coder en blocs d'au plus taille_bloc octets (0 : HUFF_BLOC_FLUX, sinon au moins 4096) ;
+   retourne HUFF_OK ou HUFF_ERREUR_TRAVAIL */
+HUFF_API int huff_encoder_init(huff_stream *f, size_t taille_bloc, void *travail, size_t taille_travail);
+
+/* code ce qui est disponible à f->entree vers f->sortie ; retourne HUFF_OK, ou HUFF_FINI en mode HUFF_FIN quand toute
+   l'entrée a été écrite. En mode HUFF_VIDER, tout est écrit quand le retour laisse de la place en sortie */
+HUFF_API int huff_encode(huff_stream *f, int mode);
+
+/* prépare f pour décoder ; retourne HUFF_OK ou HUFF_ERREUR_TRAVAIL */
+HUFF_API int huff_decoder_init(huff_stream *f, void *travail, size_t taille_travail);
+
+/* décode ce qui est disponible à f->entree vers f->sortie en vérifiant le CRC32C de chaque bloc ; retourne HUFF_OK,
+   HUFF_FINI en mode HUFF_FIN si l'entrée finit entre deux blocs et que tout a été écrit, ou HUFF_ERREUR_DONNEES,
+   définitivement, si les données sont invalides ou, en mode HUFF_FIN, tronquées */
+HUFF_API int huff_decode(huff_stream *f, int mode);
+
+/* ouvre le fichier compressé chemin comme un FILE * ordinaire : mode "r" le décompresse à la lecture, "w" ou "a" compresse
+   ce qui est écrit, en blocs d'au plus 1 Mio ("a" ajoute des blocs à la fin d'un fichier existant) ; le dernier bloc n'est
+   écrit qu'à la fermeture, qui doit passer par fclose. Retourne NULL (errno indique pourquoi) si l'ouverture échoue ;
+   une lecture de données invalides échoue avec errno à EIO */
+HUFF_API FILE *huff_fopen(const char *chemin, const char *mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_LIBHUFFMAN_H_ */
@@ -0,0 +1,241 @@
+#ifndef _LIBHUFFMAN_HPP_
+#define _LIBHUFFMAN_HPP_
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#if __has_include(<span>)
+#include <span>
+#endif
+#include "libhuffman.h"
+
+/* libhuffman en C++17, sans rien à compiler : une fine couche sur l'interface C
+
+Les entrées sont des vues sur des octets, les sorties des vues fournies par l'appelant ou des std::vector réutilisés (seule leur
+taille change, leur capacité ne fait que grandir). Chaque codeur ou décodeur garde sa mémoire de travail : après la construction,
+les appels n'allouent plus rien, si bien qu'un même objet peut servir à des millions de messages. Les objets se déplacent mais
+ne se copient pas ; un objet déplacé ne doit plus servir. Une erreur lève huff::erreur, qui porte le code HUFF_ERREUR_*.
+ */
+
+namespace huff
+{
+
+#if defined(__cpp_lib_span)
+using octets = std::span<const std::byte>;
+using octets_modifiables = std::span<std::byte>;
+#else
+/* std::span n'arrive qu'avec C++20 : en C++17, une vue réduite au nécessaire */
+template <class T>
+class vue
+{
+  public:
+    constexpr vue() noexcept : donnees_(nullptr), taille_(0) {}
+    constexpr vue(T *donnees, std::size_t taille) noexcept : donnees_(donnees), taille_(taille) {}
+    template <class U, class = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    constexpr vue(const vue<U> &autre) noexcept : donnees_(autre.data()), taille_(autre.size()) {}
+    template <class C, class = std::enable_if_t<std::is_convertible_v<std::remove_pointer_t<decltype(std::declval<C &>().data())> (*)[], T (*)[]>>>
+    constexpr vue(C &conteneur) noexcept : donnees_(conteneur.data()), taille_(conteneur.size()) {}
+    constexpr T *data() const noexcept { return donnees_; }
+    constexpr std::size_t size() const noexcept { return taille_; }
+    constexpr vue subspan(std::size_t debut) const noexcept { return vue(donnees_ + debut, taille_ - debut); }
+
+  private:
+    T *donnees_;
+    std::size_t taille_;
+};
+using octets = vue<const std::byte>;
+using octets_modifiables = vue<std::byte>;
+#endif
+
+class erreur : public std::runtime_error
+{
+  public:
+    explicit erreur(long code)
+        : std::runtime_error(code == HUFF_ERREUR_PLACE ? "libhuffman : sortie trop petite"
+                             : code == HUFF_ERREUR_DONNEES ? "libhuffman : donnees invalides"
+                                                           : "libhuffman : memoire de travail invalide"),
+          code_(code)
+    {
+    }
+    long code() const noexcept { return code_; }
+
+  private:
+    long code_;
+};
+
+namespace detail
+{
+/* mémoire de travail alignée comme un pointeur, comme le demande l'interface C */
+class travail
+{
+  public:
+    explicit travail(std::size_t taille)
+        : memoire_(new std::max_align_t[(taille + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]), taille_(taille)
+    {
+    }
+    void *data() const noexcept { return memoire_.get(); }
+    std::size_t size() const noexcept { return taille_; }
+
+  private:
+    std::unique_ptr<std::max_align_t[]> memoire_;
+    std::size_t taille_;
+};
+
+inline std::size_t verifier(long retour)
+{
+    if (retour < 0)
+    {
+        throw erreur(retour);
+    }
+    return static_cast<std::size_t>(retour);
+}
+
+inline const unsigned char *entree(octets src) noexcept { return reinterpret_cast<const unsigned char *>(src.data()); }
+inline unsigned char *sortie(octets_modifiables dst) noexcept { return reinterpret_cast<unsigned char *>(dst.data()); }
+} // namespace detail
+
+/* taille maximale du résultat de compresser pour n octets */
+inline std::size_t borne_compression(std::size_t n) noexcept { return huff_compress_bound(n); }
+
+/* taille d'origine des données compressées src, lue dans les en-têtes des blocs */
+inline std::size_t taille_origine(octets src) { return detail::verifier(huff_decompressed_size(detail::entree(src), src.size())); }
+
+/* compression d'un tampon entier vers un autre */
+class codeur
+{
+  public:
+    codeur() : travail_(HUFF_TAILLE_TRAVAIL) {}
+    codeur(codeur &&) noexcept = default;
+    codeur &operator=(codeur &&) noexcept = default;
+    codeur(const codeur &) = delete;
+    codeur &operator=(const codeur &) = delete;
+
+    /* retourne la taille du résultat écrit au début de dst */
+    std::size_t compresser(octets src, octets_modifiables dst)
+    {
+        return detail::verifier(huff_compress(detail::entree(src), src.size(), detail::sortie(dst), dst.size(), travail_.data(), travail_.size()));
+    }
+
+    /* dst prend la taille du résultat ; il n'est agrandi que si sa capacité ne suffit pas à borne_compression */
+    void compresser(octets src, std::vector<std::byte> &dst)
+    {
+        dst.resize(borne_compression(src.size()));
+        dst.resize(compresser(src, octets_modifiables(dst.data(), dst.size())));
+    }
+
+  private:
+    detail::travail travail_;
+};
+
+/* décompression d'un tampon entier vers un autre */
+class decodeur
+{
+  public:
+    decodeur() : travail_(HUFF_TAILLE_TRAVAIL) {}
+    decodeur(decodeur &&) noexcept = default;
+    decodeur &operator=(decodeur &&) noexcept = default;
+    decodeur(const decodeur &) = delete;
+    decodeur &operator=(const decodeur &) = delete;
+
+    /* retourne la taille d'origine, écrite au début de dst */
+    std::size_t decompresser(octets src, octets_modifiables dst)
+    {
+        return detail::verifier(huff_decompress(detail::entree(src), src.size(), detail::sortie(dst), dst.size(), travail_.data(), travail_.size()));
+    }
+
+    /* dst prend la taille d'origine ; il n'est agrandi que si sa capacité ne suffit pas */
+    void decompresser(octets src, std::vector<std::byte> &dst)
+    {
+        dst.resize(taille_origine(src));
+        decompresser(src, octets_modifiables(dst.data(), dst.size()));
+    }
+
+  private:
+    detail::travail travail_;
+};
+
+/* mode des appels d'un flux, voir huff_encode */
+enum class mode : int
+{
+    continuer = HUFF_CONTINUER,
+    vider = HUFF_VIDER,
+    fin = HUFF_FIN
+};
+
+/* ce qu'un appel à un flux a lu de l'entrée et écrit en sortie ; fini : voir HUFF_FINI */
+struct avancee
+{
+    std::size_t lus;
+    std::size_t ecrits;
+    bool fini;
+};
+
+namespace detail
+{
+inline avancee avancer(huff_stream &f, int (*fonction)(huff_stream *, int), octets src, octets_modifiables dst, mode m)
+{
+    int retour;
+
+    f.entree = entree(src);
+    f.nb_entree = src.size();
+    f.sortie = sortie(dst);
+    f.nb_sortie = dst.size();
+    retour = fonction(&f, static_cast<int>(m));
+    verifier(retour);
+    return avancee{src.size() - f.nb_entree, dst.size() - f.nb_sortie, retour == HUFF_FINI};
+}
+} // namespace detail
+
+/* compression par morceaux (voir huff_encode) : l'appelant redonne ce qui n'a pas été lu et vide ce qui a été écrit */
+class flux_codeur
+{
+  public:
+    explicit flux_codeur(std::size_t taille_bloc = 0) : travail_(huff_encoder_size(taille_bloc)), taille_bloc_(taille_bloc)
+    {
+        recommencer();
+    }
+    flux_codeur(flux_codeur &&) noexcept = default;
+    flux_codeur &operator=(flux_codeur &&) noexcept = default;
+    flux_codeur(const flux_codeur &) = delete;
+    flux_codeur &operator=(const flux_codeur &) = delete;
+
+    avancee coder(octets src, octets_modifiables dst, mode m = mode::continuer)
+    {
+        return detail::avancer(flux_, huff_encode, src, dst, m);
+    }
+
+    /* abandonne le flux en cours et en commence un autre, dans la même mémoire */
+    void recommencer() { detail::verifier(huff_encoder_init(&flux_, taille_bloc_, travail_.data(), travail_.size())); }
+
+  private:
+    detail::travail travail_;
+    std::size_t taille_bloc_;
+    huff_stream flux_;
+};
+
+/* décompression par morceaux (voir huff_decode) */
+class flux_decodeur
+{
+  public:
+    flux_decodeur() : travail_(HUFF_TAILLE_DECODEUR) { recommencer(); }
+    flux_decodeur(flux_decodeur &&) noexcept = default;
+    flux_decodeur &operator=(flux_decodeur &&) noexcept = default;
+    flux_decodeur(const flux_decodeur &) = delete;
+    flux_decodeur &operator=(const flux_decodeur &) = delete;
+
+    avancee decoder(octets src, octets_modifiables dst, mode m = mode::continuer)
+    {
+        return detail::avancer(flux_, huff_decode, src, dst, m);
+    }
+
+    void recommencer() { detail::verifier(huff_decoder_init(&flux_, travail_.data(), travail_.size())); }
+
+  private:
+    detail::travail travail_;
+    huff_stream flux_;
+};
+
+} // namespace huff
+
+#endif /*_LIBHUFFMAN_HPP_ */
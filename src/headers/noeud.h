@@ -17,6 +17,9 @@ void deux_plus_petits(int tableau[], int taille, int *p1, int *p2);
 /* Question 7 : creer_noeud */
 void creer_noeud(noeud *tab[], int taille);
 
+/* même chose, mais le noeud créé est n, fourni par l'appelant ; retourne 1 si n a servi et 0 sinon */
+int creer_noeud_dans(noeud *tab[], int taille, noeud *n);
+
 /* Fonction pour libérer récursivement un arbre Huffman */
 void liberer_arbre(noeud *racine);
 
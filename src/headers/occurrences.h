@@ -8,4 +8,7 @@ void ouvrir_fichier(FILE *fic);
 void lecture_fichier(FILE *fic);
 void occurence(FILE *fic, int tab[]);
 
+/* même chose que occurence sur les taille octets d'un tampon déjà en mémoire */
+void occurence_tampon(const unsigned char *tampon, size_t taille, long tab[]);
+
 #endif /*_OCCURRENCES_H_ */
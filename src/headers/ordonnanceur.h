@@ -0,0 +1,62 @@
+#ifndef _ORDONNANCEUR_H_
+#define _ORDONNANCEUR_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "util.h"
+
+/* Répartition des tâches de compression entre les fils, par vol de travail
+
+Chaque fil a sa file de tâches à deux bouts. Les tâches soumises ensemble sont triées de la plus coûteuse à la moins
+coûteuse puis distribuées à tour de rôle : chaque fil commence par ses plus grosses et, quand sa file est vide, vole la
+plus petite tâche de la file la plus chargée. Les gros travaux partent donc en premier et les petits comblent la fin.
+ */
+
+typedef struct tache
+{
+  long cout;                          /* octets à traiter */
+  void (*executer)(struct tache *t);
+  int ordre;                          /* rang dans la soumission : à coût égal, la première soumise passe avant */
+  int finie;
+} tache;
+
+typedef struct deque_taches
+{
+  tache **taches;
+  int debut, fin, capacite;           /* tâches debut..fin-1 ; le propriétaire prend au début, les voleurs à la fin */
+  pthread_mutex_t verrou;
+} deque_taches;
+
+struct ordonnanceur;
+
+typedef struct fil_ordonnanceur
+{
+  struct ordonnanceur *o;
+  int numero;
+} fil_ordonnanceur;
+
+typedef struct ordonnanceur
+{
+  deque_taches deques[NB_MAX_FILS];
+  fil_ordonnanceur arguments[NB_MAX_FILS];
+  pthread_t fils[NB_MAX_FILS];
+  int nb_fils, suivant;
+  int nb_en_file, arret;              /* tâches pas encore prises ; demande d'arrêt */
+  pthread_mutex_t verrou;
+  pthread_cond_t travail, termine;
+} ordonnanceur;
+
+/* démarre un fil par cœur */
+void lancer_ordonnanceur(ordonnanceur *o);
+
+/* ajoute les nb tâches aux files des fils, les plus coûteuses en tête */
+void soumettre_taches(ordonnanceur *o, tache *taches[], int nb);
+
+/* attend la fin de la tâche t */
+void attendre_tache(ordonnanceur *o, tache *t);
+
+/* laisse finir les tâches en file puis arrête les fils */
+void arreter_ordonnanceur(ordonnanceur *o);
+
+#endif /*_ORDONNANCEUR_H_ */
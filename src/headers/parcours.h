@@ -0,0 +1,51 @@
+#ifndef _PARCOURS_H_
+#define _PARCOURS_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "util.h"
+
+/* Parcours des dossiers à archiver, sans limite de nombre de fichiers ni de longueur de chemin
+
+Les chemins sont copiés dans une arène (une suite de grands blocs jamais déplacés) : un chemin ne coûte pas de malloc
+et reste valable jusqu'à liberer_liste. Les dossiers sont parcourus en parallèle : chaque fil descend avec openat
+depuis le descripteur du dossier parent et ne confie un sous-dossier à la file commune que si d'autres fils attendent.
+Un fil ne garde pas plus de PROFONDEUR_OUVERTE dossiers ouverts : plus bas, les sous-dossiers attendent sur sa pile et
+sont rouverts par leur chemin, si bien que la profondeur n'est pas limitée par le nombre de descripteurs.
+ */
+
+#define TAILLE_BLOC_ARENE (1 << 20)
+/* dossiers ouverts au plus par un fil du parcours */
+#define PROFONDEUR_OUVERTE 32
+
+typedef struct bloc_arene
+{
+  struct bloc_arene *precedent;
+  size_t utilise, taille;
+  char donnees[];
+} bloc_arene;
+
+typedef struct liste_chemins
+{
+  char **chemins;      /* chemins des fichiers, dans l'arène */
+  int nb, capacite;
+  bloc_arene *arene;   /* dernier bloc de l'arène */
+} liste_chemins;
+
+/* liste vide */
+void init_liste(liste_chemins *l);
+
+/* copie dans l'arène de l les n premiers caractères de s, suivis d'un \0 */
+char *copier_chemin(liste_chemins *l, const char *s, size_t n);
+
+/* ajoute une copie de chemin à la liste */
+void ajouter_chemin(liste_chemins *l, const char *chemin);
+
+/* ajoute à l les fichiers ordinaires de l'arborescence racine (les liens vers des fichiers compris, les liens vers des dossiers
+   ne sont pas suivis), triés par chemin */
+void parcourir_dossier(char *racine, liste_chemins *l);
+
+void liberer_liste(liste_chemins *l);
+
+#endif /*_PARCOURS_H_ */
@@ -0,0 +1,79 @@
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+/* Chaîne lecture -> codage -> écriture pour les gros membres
+
+Un fil lit le fichier de départ, le fil appelant code ou décode, un troisième fil écrit le résultat : le processeur
+n'attend plus le disque ni le disque le processeur. Les étapes se passent des tampons de taille fixe par des anneaux
+à un seul producteur et un seul consommateur, sans verrou ; un anneau plein fait attendre celui qui le remplit.
+En dessous de TAILLE_MIN_PIPELINE, lancer des fils coûte plus que ce qu'ils font gagner : le flux lit et écrit
+directement dans les fichiers.
+ */
+
+#define TAILLE_TAMPON_ANNEAU (256 * 1024)
+/* puissance de 2 */
+#define NB_TAMPONS_ANNEAU 8
+#define TAILLE_MIN_PIPELINE (1024 * 1024)
+
+typedef struct anneau
+{
+  unsigned char *memoire;               /* NB_TAMPONS_ANNEAU tampons de TAILLE_TAMPON_ANNEAU octets */
+  size_t tailles[NB_TAMPONS_ANNEAU];    /* octets utiles de chaque tampon */
+  unsigned tete, queue;                 /* nombre de tampons rendus par le consommateur et publiés par le producteur */
+  int fini, abandon;                    /* le producteur n'a plus rien / le consommateur ne veut plus rien */
+  unsigned sequence;                    /* change à chaque événement, pour attendre sans tourner */
+  int nb_en_attente;
+} anneau;
+
+/* côté producteur : un tampon libre (NULL si le consommateur a abandonné), sa publication avec taille octets utiles, la fin */
+unsigned char *tampon_libre(anneau *a);
+void publier(anneau *a, size_t taille);
+void clore(anneau *a);
+
+/* côté consommateur : le prochain tampon publié (NULL à la fin), sa restitution, l'abandon */
+unsigned char *tampon_plein(anneau *a, size_t *taille);
+void rendre(anneau *a);
+void abandonner(anneau *a);
+
+/* lecture ou écriture séquentielle, directe dans fic si a est NULL, sinon à travers l'anneau */
+typedef struct flux
+{
+  FILE *fic;             /* NULL en écriture : les données sont jetées */
+  anneau *a;
+  unsigned char *tampon; /* tampon de l'anneau en cours d'utilisation */
+  size_t pos, taille;
+} flux;
+
+void init_flux(flux *f, FILE *fic, anneau *a);
+
+/* lit au plus n octets ; retourne le nombre lu, moins de n seulement à la fin */
+size_t lire_flux(flux *f, void *dst, size_t n);
+
+void ecrire_flux(flux *f, const void *src, size_t n);
+
+/* remplit tampon (n octets au plus) depuis fic ; retourne 0 quand il n'y a plus rien à lire pour ce membre */
+typedef size_t (*fonction_lecture)(FILE *fic, unsigned char *tampon, size_t n, void *etat);
+
+typedef struct pipeline
+{
+  anneau entree, sortie;
+  flux lecture, ecriture;   /* ce que lit et écrit l'étape de codage */
+  FILE *src, *dst;
+  fonction_lecture lire;
+  void *etat;
+  pthread_t lecteur, ecrivain;
+  int lecteur_lance, ecrivain_lance, erreur_ecriture;
+} pipeline;
+
+/* prépare la chaîne pour un membre d'environ taille octets lu dans src et écrit dans dst (NULL : nulle part) ; lire (NULL : fread
+   jusqu'à la fin de src) doit s'arrêter à la fin du membre, car le fil lecteur lit en avance */
+void ouvrir_pipeline(pipeline *p, FILE *src, fonction_lecture lire, void *etat, FILE *dst, long taille);
+
+/* vide ce qui reste à écrire et arrête les fils ; retourne 0 si tout a été écrit et -1 sinon */
+int fermer_pipeline(pipeline *p);
+
+#endif /*_PIPELINE_H_ */
@@ -0,0 +1,58 @@
+#ifndef _PRELECTURE_H_
+#define _PRELECTURE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "util.h"
+#include "empreinte.h"
+
+/* Prélecture des fichiers à compresser, par lots
+
+Pour chaque lot, les fichiers sont d'abord tous examinés (taille, date), puis les petits sont ouverts et lus d'un coup
+dans une réserve de mémoire réutilisée d'un lot à l'autre. Sous Linux les opérations d'un lot sont soumises ensemble à
+io_uring (quelques appels système par lot au lieu de quatre ou cinq par fichier) ; sinon, ou si le noyau le refuse,
+des fils d'exécution font les mêmes appels en parallèle. Le compresseur lit ensuite un fichier prélu en mémoire, une
+seule fois, au lieu de l'ouvrir à chaque étape.
+ */
+
+/* nombre de fichiers examinés à la fois */
+#define NB_FICHIERS_LOT 256
+/* au-delà, le fichier est lu par morceaux pendant la compression */
+#define TAILLE_MAX_PRELUE (1024 * 1024)
+/* mémoire partagée par les contenus d'un lot */
+#define TAILLE_RESERVE (32 * 1024 * 1024)
+/* fils de la lecture sans io_uring : ils attendent surtout le disque, il en faut plus que de cœurs */
+#define NB_FILS_LECTURE 8
+
+typedef struct fichier_source
+{
+  char *chemin;
+  unsigned char *contenu;       /* contenu lu d'avance, dans la réserve, ou NULL */
+  long taille, mtime;
+  unsigned long long empreinte;
+  int erreur;                   /* 1 si le fichier n'a pas pu être examiné */
+} fichier_source;
+
+struct anneau_es;
+
+typedef struct prelecture
+{
+  fichier_source fichiers[NB_FICHIERS_LOT];
+  int nb;                       /* fichiers du lot courant */
+  unsigned char *reserve;
+  struct anneau_es *anneau;     /* NULL : lecture par les fils */
+} prelecture;
+
+void init_prelecture(prelecture *p);
+
+/* examine les premiers fichiers de liste (au plus nb) et lit d'avance les petits, avec leurs empreintes ;
+   retourne le nombre de fichiers du lot, rangés dans p->fichiers */
+int lire_lot(prelecture *p, char **liste, int nb);
+
+/* ouvre le fichier en lecture, en mémoire s'il a été lu d'avance ; NULL en cas d'erreur */
+FILE *ouvrir_source(fichier_source *f);
+
+void liberer_prelecture(prelecture *p);
+
+#endif /*_PRELECTURE_H_ */
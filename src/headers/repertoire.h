@@ -0,0 +1,72 @@
+#ifndef _REPERTOIRE_H_
+#define _REPERTOIRE_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "blocs.h"
+
+/* Répertoire central écrit à la fin de l'archive, pour lister et extraire un membre sans lire ceux qui le précèdent
+
+répertoire => I<nombre de membres> puis \n, puis une ligne par membre :
+              <position> <taille dans l'archive> <taille d'origine> <crc32c en hexadécimal> <position de la table partagée ou -1>
+              <date de modification> <empreinte en hexadécimal, 0 si inconnue> <nombre de blocs indexés> <nom>
+              suivie, pour un membre en blocs, d'une ligne J puis <debut> <position> <position de la table> pour chaque bloc
+pied => IDX suivi de la position du répertoire sur 20 chiffres et \n, toujours les TAILLE_PIED derniers octets de l'archive
+ */
+
+#define TAILLE_PIED 25
+
+typedef struct entree_repertoire
+{
+  long position;        /* début du membre dans l'archive */
+  long taille_membre;   /* octets occupés par le membre dans l'archive */
+  long taille;          /* taille d'origine */
+  unsigned int crc;     /* CRC32C du contenu d'origine */
+  long position_table;  /* membre P : position de la table partagée, -1 sinon */
+  long mtime;           /* date de modification du fichier d'origine */
+  unsigned long long empreinte; /* empreinte du contenu d'origine (empreinte.h), 0 si elle n'a pas été calculée */
+  index_blocs index;    /* membre B : ses blocs, vide sinon */
+  char *nom;
+} entree_repertoire;
+
+typedef struct repertoire
+{
+  entree_repertoire *entrees;
+  int nb, capacite;
+  int *par_empreinte;  /* table de hachage des empreintes connues : indice + 1 de la 1ère entrée qui l'a, 0 pour une case vide */
+  int taille_hachage;  /* puissance de 2, au moins le double de nb */
+} repertoire;
+
+/* répertoire vide */
+void init_repertoire(repertoire *r);
+
+/* ajoute une copie de e (nom compris) à r ; l'index de blocs de e appartient ensuite à r */
+void ajouter_entree(repertoire *r, entree_repertoire *e);
+
+/* écrit r puis le pied à la position courante de fic, qui doit être la fin de l'archive */
+void ecrire_repertoire(FILE *fic, repertoire *r);
+
+/* lit le répertoire d'une archive ; retourne 0 si tout va bien et -1 si l'archive n'en a pas */
+int lire_repertoire(FILE *fic, repertoire *r);
+
+/* position du répertoire de fic (début des données à remplacer pour ajouter des membres), -1 s'il n'y en a pas */
+long position_repertoire(FILE *fic);
+
+/* lit le répertoire de fic et s'y positionne, pour que les membres ajoutés le remplacent ; retourne 0 si tout va bien et -1 sinon */
+int ouvrir_ajout(FILE *fic, repertoire *r);
+
+/* entrée du membre nom (la plus récente s'il a été ajouté plusieurs fois), NULL s'il n'y est pas */
+entree_repertoire *chercher_entree(repertoire *r, char *nom);
+
+/* 1ère entrée de r dont le contenu a l'empreinte et la taille de e, NULL s'il n'y en a pas (ou si l'empreinte de e est inconnue) */
+entree_repertoire *chercher_empreinte(repertoire *r, entree_repertoire *e);
+
+/* entrée du membre qui commence à position (les membres sont rangés dans l'ordre de l'archive), NULL s'il n'y en a pas */
+entree_repertoire *entree_a_position(repertoire *r, long position);
+
+/* entrée du membre nom qui a le contenu de reference (même taille et même CRC) et la précède, NULL s'il n'y en a pas */
+entree_repertoire *chercher_source(repertoire *r, char *nom, entree_repertoire *reference);
+
+void liberer_repertoire(repertoire *r);
+
+#endif /*_REPERTOIRE_H_ */
@@ -0,0 +1,31 @@
+#ifndef _SYNCHRONISATION_H_
+#define _SYNCHRONISATION_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "types.h"
+#include "canonique.h"
+#include "ordonnanceur.h"
+
+/* Décodage parallèle des membres au format d'origine, qui n'ont ni blocs ni index
+
+Le contenu codé est découpé en parts de TAILLE_PART_ORIGINE octets. Chaque part est décodée par un fil à partir de son
+premier bit, sans savoir si un code y commence : le décodage est spéculatif. Un code de Huffman se resynchronise vite,
+si bien que le décodage d'une part finit par tomber sur une frontière de code du décodage exact. Les parts sont ensuite
+recousues dans l'ordre : le décodage exact de la fin de la part précédente est poursuivi bit à bit jusqu'à une frontière
+de code notée par la part suivante, dont tous les octets décodés à partir de là sont repris tels quels.
+ */
+
+/* octets codés décodés par un fil d'un coup */
+#define TAILLE_PART_ORIGINE (1024 * 1024)
+
+/* table de décodage construite avec les codes de l'en-tête d'un membre d'origine (alphabet lu par rec_alph_fich) ;
+   retourne -1 si ces codes ne forment pas un code préfixe d'au plus LONGUEUR_MAX_CODE bits, 0 sinon */
+int table_origine(noeud *alphabet[], table_codes *t);
+
+/* décode nb_octets octets depuis les nb_bits bits (arrondis à l'octet) qui suivent dans fic, vers fic_decom (NULL : nulle
+   part), avec les fils de o (NULL : ici seulement), et calcule leur CRC32C ;
+   consomme exactement le contenu codé ; retourne 0 si tout va bien et -1 sinon */
+int decoder_origine(FILE *fic, FILE *fic_decom, const table_codes *t, long nb_octets, long long nb_bits, ordonnanceur *o, unsigned int *crc);
+
+#endif /*_SYNCHRONISATION_H_ */
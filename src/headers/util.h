@@ -5,10 +5,13 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <dirent.h>
+#include <unistd.h>
 #include "noeud.h"
 #include "types.h"
+#include "controle.h"
 
-#define MAX_FICHIERS 100
+#define TAILLE_TAMPON_COPIE 65536
+#define NB_MAX_FILS 16
 
 /* fonction qui retourne le nombre de lettres dans l'alphabet (donc le nombre de noeuds non NULL dans alphabet) */
 int compter_lettres_alphabet(noeud *alphabet[]);
@@ -21,10 +24,24 @@ char *conversion_binaire(char c);
 
 void afficher_arbre(arbre a, int niveau);
 
-int compter_elements_dossier(char *chemin);
+void mkdir_p(char *chemin);
 
-void lecture_dossier(char *chemin_dossier, char **liste_fichiers, int *indice);
+/* copie taille octets de src (à partir de sa position courante) vers dst, avec copy_file_range quand c'est possible ; retourne 0 si tout a été copié et -1 sinon */
+int copie_brute(FILE *src, FILE *dst, long taille);
 
-void mkdir_p(char *chemin);
+/* copie taille octets de src vers dst (NULL : nulle part) en poursuivant le CRC32C *crc ; retourne 0 si tout a été copié et -1 sinon */
+int copie_crc(FILE *src, FILE *dst, long taille, unsigned int *crc);
+
+/* nombre de fils d'exécution à lancer pour un travail parallèle : un par cœur, au plus NB_MAX_FILS */
+int nb_fils_disponibles(void);
+
+/* retourne 1 si le fichier chemin1 a exactement le même contenu que fic2 (relu depuis sa position courante puis rembobiné) et 0 sinon */
+int fichiers_identiques(char *chemin1, FILE *fic2);
+
+/* fait de destination un lien physique vers source, ou une copie si le lien est impossible ; retourne 0 si tout va bien et -1 sinon */
+int lier_ou_copier(char *source, char *destination);
+
+/* coupe fic à sa position courante (ce qui suivait est perdu) ; retourne 0 si tout va bien et -1 sinon */
+int tronquer_fichier(FILE *fic);
 
 #endif /*_UTIL_H_ */
@@ -0,0 +1,19 @@
+#ifndef _VERIFICATION_H_
+#define _VERIFICATION_H_
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+#include "archive.h"
+#include "util.h"
+
+/* Test d'une archive sans rien extraire : chaque membre est décodé vers nulle part et son CRC32C comparé à celui du répertoire
+   central ; les membres sont répartis entre plusieurs fils, chacun avec sa propre lecture de l'archive. Une archive sans
+   répertoire central est décodée membre après membre, sans CRC32C à comparer */
+
+/* teste l'archive chemin (dico sert aux membres R) et affiche l'état, le temps et le débit de décodage de chaque membre,
+   puis le débit total ;
+   retourne le nombre de membres en erreur, ou -1 si l'archive est illisible */
+int tester_archive(char *chemin, dictionnaire *dico);
+
+#endif /*_VERIFICATION_H_ */
@@ -0,0 +1,448 @@
+#include <stdint.h>
+#include "libhuffman.h"
+#include "blocs.h"
+
+/* la mémoire de travail sert au codeur de blocs ou à la table du décodeur */
+typedef char verifier_taille_travail[sizeof(codeur_blocs) <= HUFF_TAILLE_TRAVAIL && sizeof(table_codes) <= HUFF_TAILLE_TRAVAIL ? 1 : -1];
+
+/* au plus un bloc par fenêtre de point_de_coupe, et jamais plus d'un bloc de TAILLE_BLOC_GRAND octets */
+#define TAILLE_BLOC_BIBLIOTHEQUE TAILLE_BLOC_GRAND
+
+static int travail_valide(void *travail, size_t taille_travail)
+{
+    return travail != NULL && taille_travail >= HUFF_TAILLE_TRAVAIL && (uintptr_t)travail % sizeof(void *) == 0;
+}
+
+size_t huff_compress_bound(size_t n)
+{
+    /* un bloc codé n'est gardé que s'il est plus petit que stocké : au pire, chaque bloc est stocké avec son en-tête */
+    return n + (n / FENETRE_DECOUPE + 1) * TAILLE_EN_TETE_BLOC;
+}
+
+long huff_compress(const void *src, size_t n, void *dst, size_t capacite, void *travail, size_t taille_travail)
+{
+    const unsigned char *entree = (const unsigned char *)src;
+    unsigned char *sortie = (unsigned char *)dst;
+    codeur_blocs *c;
+    long tab[256];
+    size_t pos = 0, ecrit = 0, lu, taille;
+    char type;
+
+    if (!travail_valide(travail, taille_travail))
+    {
+        return HUFF_ERREUR_TRAVAIL;
+    }
+    c = (codeur_blocs *)travail;
+    init_codeur_blocs(c);
+    while (pos < n)
+    {
+        lu = point_de_coupe(entree + pos, n - pos < TAILLE_BLOC_BIBLIOTHEQUE ? n - pos : TAILLE_BLOC_BIBLIOTHEQUE, tab);
+        /* la taille exacte du bloc est connue avant de l'écrire : il est codé directement dans dst */
+        taille = preparer_bloc(c, tab, lu, &type);
+        if (taille > capacite - ecrit)
+        {
+            return HUFF_ERREUR_PLACE;
+        }
+        ecrire_bloc(c, entree + pos, lu, type, taille, sortie + ecrit);
+        pos += lu;
+        ecrit += taille;
+    }
+    return (long)ecrit;
+}
+
+long huff_decompressed_size(const void *src, size_t n)
+{
+    const unsigned char *entree = (const unsigned char *)src;
+    size_t pos = 0;
+    long longueur, total = 0;
+
+    while (pos < n)
+    {
+        if (n - pos < TAILLE_EN_TETE_BLOC || (longueur = longueur_bloc(entree + pos)) < 0 || (size_t)longueur > n - pos)
+        {
+            return HUFF_ERREUR_DONNEES;
+        }
+        total += taille_bloc_clair(entree + pos);
+        pos += longueur;
+    }
+    return total;
+}
+
+long huff_decompress(const void *src, size_t n, void *dst, size_t capacite, void *travail, size_t taille_travail)
+{
+    const unsigned char *entree = (const unsigned char *)src;
+    unsigned char *sortie = (unsigned char *)dst;
+    size_t pos = 0, ecrit = 0;
+    long longueur, taille_bloc;
+    unsigned int crc_bloc;
+    int table_lue = 0;
+
+    if (!travail_valide(travail, taille_travail))
+    {
+        return HUFF_ERREUR_TRAVAIL;
+    }
+    while (pos < n)
+    {
+        if (n - pos < TAILLE_EN_TETE_BLOC || (longueur = longueur_bloc(entree + pos)) < 0 || (size_t)longueur > n - pos)
+        {
+            return HUFF_ERREUR_DONNEES;
+        }
+        taille_bloc = taille_bloc_clair(entree + pos);
+        if ((size_t)taille_bloc > capacite - ecrit)
+        {
+            return HUFF_ERREUR_PLACE;
+        }
+        if (decoder_bloc((table_codes *)travail, &table_lue, entree + pos, sortie + ecrit, &crc_bloc) != 0 ||
+            crc_bloc != crc_bloc_annonce(entree + pos))
+        {
+            return HUFF_ERREUR_DONNEES;
+        }
+        pos += longueur;
+        ecrit += taille_bloc;
+    }
+    return (long)ecrit;
+}
+
+/* étapes d'un flux */
+#define ETAPE_ENTREE 0    /* codeur : remplit le bloc ; décodeur : lit l'en-tête du bloc suivant */
+#define ETAPE_TABLE 1     /* décodeur : lit la table d'un bloc N */
+#define ETAPE_CONTENU 2   /* écrit ou décode le contenu du bloc en cours */
+#define ETAPE_ERREUR 3
+
+typedef struct etat_codeur
+{
+  codeur_blocs blocs;
+  size_t taille_bloc, nb_donnees;   /* capacité et remplissage de donnees */
+  size_t lu, code;                  /* le bloc en cours est donnees[0..lu[, dont code octets sont déjà codés */
+  char type;
+  int etape;
+  unsigned long long acc;           /* écrivain de bits d'un appel à l'autre */
+  int nb;
+  unsigned char attente[TAILLE_EN_TETE_BLOC + TAILLE_TABLE + 8];   /* produit, mais pas encore de place en sortie */
+  size_t debut_attente, fin_attente;
+  unsigned char donnees[];
+} etat_codeur;
+
+typedef struct etat_decodeur
+{
+  table_codes table;
+  int table_lue, etape;
+  unsigned char en_tete[TAILLE_EN_TETE_BLOC + TAILLE_TABLE];
+  size_t nb_en_tete;
+  long restant_clair, restant_code;   /* octets du bloc en cours pas encore décodés, octets de code pas encore lus */
+  unsigned long long acc;             /* lecteur de bits d'un appel à l'autre */
+  int nb;
+  unsigned int crc, crc_attendu;
+} etat_decodeur;
+
+typedef char verifier_taille_decodeur[sizeof(etat_decodeur) <= HUFF_TAILLE_DECODEUR ? 1 : -1];
+
+static size_t lire_entree(huff_stream *f, unsigned char *dst, size_t n)
+{
+    n = n < f->nb_entree ? n : f->nb_entree;
+    memcpy(dst, f->entree, n);
+    f->entree += n;
+    f->nb_entree -= n;
+    f->total_entree += n;
+    return n;
+}
+
+static size_t ecrire_sortie(huff_stream *f, const unsigned char *src, size_t n)
+{
+    n = n < f->nb_sortie ? n : f->nb_sortie;
+    memcpy(f->sortie, src, n);
+    f->sortie += n;
+    f->nb_sortie -= n;
+    f->total_sortie += n;
+    return n;
+}
+
+size_t huff_encoder_size(size_t taille_bloc)
+{
+    return sizeof(etat_codeur) + (taille_bloc == 0 ? HUFF_BLOC_FLUX : taille_bloc);
+}
+
+int huff_encoder_init(huff_stream *f, size_t taille_bloc, void *travail, size_t taille_travail)
+{
+    etat_codeur *c = (etat_codeur *)travail;
+
+    if (taille_bloc == 0)
+    {
+        taille_bloc = HUFF_BLOC_FLUX;
+    }
+    /* les tailles d'un bloc tiennent sur 4 octets */
+    if (travail == NULL || (uintptr_t)travail % sizeof(void *) != 0 || taille_bloc < FENETRE_DECOUPE ||
+        taille_bloc > 0x7fffffff / LONGUEUR_MAX_CODE || taille_travail < huff_encoder_size(taille_bloc))
+    {
+        return HUFF_ERREUR_TRAVAIL;
+    }
+    init_codeur_blocs(&c->blocs);
+    c->taille_bloc = taille_bloc;
+    c->nb_donnees = c->lu = c->code = 0;
+    c->etape = ETAPE_ENTREE;
+    c->acc = 0;
+    c->nb = 0;
+    c->debut_attente = c->fin_attente = 0;
+    f->total_entree = f->total_sortie = 0;
+    f->etat = c;
+    return HUFF_OK;
+}
+
+int huff_encode(huff_stream *f, int mode)
+{
+    etat_codeur *c = (etat_codeur *)f->etat;
+    ecrivain_bits e;
+    long tab[256];
+    size_t n;
+
+    for (;;)
+    {
+        c->debut_attente += ecrire_sortie(f, c->attente + c->debut_attente, c->fin_attente - c->debut_attente);
+        if (c->debut_attente < c->fin_attente)
+        {
+            return HUFF_OK;
+        }
+        c->debut_attente = c->fin_attente = 0;
+        if (c->etape == ETAPE_ENTREE)
+        {
+            c->nb_donnees += lire_entree(f, c->donnees + c->nb_donnees, c->taille_bloc - c->nb_donnees);
+            if (c->nb_donnees == 0)
+            {
+                return mode == HUFF_FIN ? HUFF_FINI : HUFF_OK;
+            }
+            /* un bloc partiel n'est coupé que si l'appelant le demande : plus tard, il aurait pu grandir */
+            if (c->nb_donnees < c->taille_bloc && mode == HUFF_CONTINUER)
+            {
+                return HUFF_OK;
+            }
+            c->lu = point_de_coupe(c->donnees, c->nb_donnees, tab);
+            n = preparer_bloc(&c->blocs, tab, c->lu, &c->type);
+            c->fin_attente = ecrire_en_tete_bloc(&c->blocs, c->donnees, c->lu, c->type, n, c->attente);
+            c->code = 0;
+            c->etape = ETAPE_CONTENU;
+        }
+        else if (c->code == c->lu)
+        {
+            /* fin du bloc : son dernier octet, puis ce qui suit le point de coupe devient le début du suivant */
+            if (c->nb > 0)
+            {
+                c->attente[c->fin_attente++] = (unsigned char)(c->acc << (8 - c->nb));
+                c->nb = 0;
+                continue;
+            }
+            memmove(c->donnees, c->donnees + c->lu, c->nb_donnees - c->lu);
+            c->nb_donnees -= c->lu;
+            c->lu = c->code = 0;
+            c->etape = ETAPE_ENTREE;
+        }
+        else if (f->nb_sortie == 0)
+        {
+            return HUFF_OK;
+        }
+        else if (c->type == BLOC_STOCKE)
+        {
+            c->code += ecrire_sortie(f, c->donnees + c->code, c->lu - c->code);
+        }
+        else
+        {
+            /* n codes tiennent toujours en n * LONGUEUR_MAX_CODE / 8 + 1 octets : directement en sortie s'il y a la place,
+               sinon un code à la fois dans attente */
+            n = (f->nb_sortie - 1) * 8 / LONGUEUR_MAX_CODE;
+            n = n < c->lu - c->code ? n : c->lu - c->code;
+            e.tampon = n > 0 ? f->sortie : c->attente;
+            e.pos = 0;
+            e.acc = c->acc;
+            e.nb = c->nb;
+            coder_tampon(&e, c->blocs.precedente, c->donnees + c->code, n > 0 ? n : 1);
+            c->code += n > 0 ? n : 1;
+            c->acc = e.acc;
+            c->nb = e.nb;
+            if (n > 0)
+            {
+                f->sortie += e.pos;
+                f->nb_sortie -= e.pos;
+                f->total_sortie += e.pos;
+            }
+            else
+            {
+                c->fin_attente = e.pos;
+            }
+        }
+    }
+}
+
+int huff_decoder_init(huff_stream *f, void *travail, size_t taille_travail)
+{
+    etat_decodeur *d = (etat_decodeur *)travail;
+
+    if (travail == NULL || (uintptr_t)travail % sizeof(void *) != 0 || taille_travail < HUFF_TAILLE_DECODEUR)
+    {
+        return HUFF_ERREUR_TRAVAIL;
+    }
+    d->table_lue = 0;
+    d->etape = ETAPE_ENTREE;
+    d->nb_en_tete = 0;
+    f->total_entree = f->total_sortie = 0;
+    f->etat = d;
+    return HUFF_OK;
+}
+
+/* décode le contenu codé du bloc en cours tant qu'il y a de l'entrée et de la place ; retourne -1 sur un code invalide */
+static int decoder_contenu(huff_stream *f, etat_decodeur *d)
+{
+    unsigned char *debut = f->sortie;
+    unsigned long long acc = d->acc;
+    unsigned int entree_table;
+    int nb = d->nb, longueur, erreur = 0;
+
+    while (d->restant_clair > 0 && f->nb_sortie > 0)
+    {
+        while (nb <= 56 && d->restant_code > 0 && f->nb_entree > 0)
+        {
+            acc = (acc << 8) | *f->entree++;
+            f->nb_entree--;
+            f->total_entree++;
+            d->restant_code--;
+            nb += 8;
+        }
+        entree_table = d->table.decodage[(nb >= LONGUEUR_MAX_CODE ? acc >> (nb - LONGUEUR_MAX_CODE) : acc << (LONGUEUR_MAX_CODE - nb)) &
+                                         ((1u << LONGUEUR_MAX_CODE) - 1)];
+        longueur = entree_table & 15;
+        if (longueur == 0 || (longueur > nb && d->restant_code == 0))
+        {
+            erreur = 1;
+            break;
+        }
+        /* le code continue dans l'entrée qui n'est pas encore arrivée */
+        if (longueur > nb)
+        {
+            break;
+        }
+        *f->sortie++ = (unsigned char)(entree_table >> 4);
+        f->nb_sortie--;
+        d->restant_clair--;
+        nb -= longueur;
+    }
+    d->acc = acc;
+    d->nb = nb;
+    d->crc = crc32c(d->crc, debut, f->sortie - debut);
+    f->total_sortie += f->sortie - debut;
+    return erreur ? -1 : 0;
+}
+
+int huff_decode(huff_stream *f, int mode)
+{
+    etat_decodeur *d = (etat_decodeur *)f->etat;
+    size_t n;
+
+    for (;;)
+    {
+        switch (d->etape)
+        {
+        case ETAPE_ENTREE:
+            d->nb_en_tete += lire_entree(f, d->en_tete + d->nb_en_tete, TAILLE_EN_TETE_BLOC - d->nb_en_tete);
+            if (d->nb_en_tete < TAILLE_EN_TETE_BLOC)
+            {
+                if (mode != HUFF_FIN)
+                {
+                    return HUFF_OK;
+                }
+                if (d->nb_en_tete == 0)
+                {
+                    return HUFF_FINI;
+                }
+                d->etape = ETAPE_ERREUR;
+                break;
+            }
+            if (longueur_bloc(d->en_tete) < 0 || (d->en_tete[0] == BLOC_MEME_TABLE && !d->table_lue))
+            {
+                d->etape = ETAPE_ERREUR;
+                break;
+            }
+            d->restant_clair = taille_bloc_clair(d->en_tete);
+            d->restant_code = longueur_bloc(d->en_tete) - TAILLE_EN_TETE_BLOC - (d->en_tete[0] == BLOC_NOUVELLE_TABLE ? TAILLE_TABLE : 0);
+            d->crc_attendu = crc_bloc_annonce(d->en_tete);
+            d->crc = 0;
+            d->acc = 0;
+            d->nb = 0;
+            d->etape = d->en_tete[0] == BLOC_NOUVELLE_TABLE ? ETAPE_TABLE : ETAPE_CONTENU;
+            break;
+        case ETAPE_TABLE:
+            d->nb_en_tete += lire_entree(f, d->en_tete + d->nb_en_tete, TAILLE_EN_TETE_BLOC + TAILLE_TABLE - d->nb_en_tete);
+            if (d->nb_en_tete < TAILLE_EN_TETE_BLOC + TAILLE_TABLE)
+            {
+                if (mode != HUFF_FIN)
+                {
+                    return HUFF_OK;
+                }
+                d->etape = ETAPE_ERREUR;
+                break;
+            }
+            if (octets_en_table(d->en_tete + TAILLE_EN_TETE_BLOC, d->table.longueurs) != 0)
+            {
+                d->etape = ETAPE_ERREUR;
+                break;
+            }
+            construire_table(&d->table);
+            d->table_lue = 1;
+            d->etape = ETAPE_CONTENU;
+            break;
+        case ETAPE_CONTENU:
+            if (d->restant_clair == 0)
+            {
+                /* bloc terminé : reste éventuellement l'octet de bourrage, puis le contrôle */
+                while (d->restant_code > 0 && f->nb_entree > 0)
+                {
+                    f->entree++;
+                    f->nb_entree--;
+                    f->total_entree++;
+                    d->restant_code--;
+                }
+                if (d->restant_code > 0)
+                {
+                    if (mode != HUFF_FIN)
+                    {
+                        return HUFF_OK;
+                    }
+                    d->etape = ETAPE_ERREUR;
+                    break;
+                }
+                d->etape = d->crc == d->crc_attendu ? ETAPE_ENTREE : ETAPE_ERREUR;
+                d->nb_en_tete = 0;
+                break;
+            }
+            if (f->nb_sortie == 0)
+            {
+                return HUFF_OK;
+            }
+            if (d->en_tete[0] == BLOC_STOCKE)
+            {
+                n = (size_t)d->restant_clair < f->nb_sortie ? (size_t)d->restant_clair : f->nb_sortie;
+                n = ecrire_sortie(f, f->entree, n < f->nb_entree ? n : f->nb_entree);
+                d->crc = crc32c(d->crc, f->entree, n);
+                f->entree += n;
+                f->nb_entree -= n;
+                f->total_entree += n;
+                d->restant_clair -= (long)n;
+                d->restant_code -= (long)n;
+            }
+            else if (decoder_contenu(f, d) != 0)
+            {
+                d->etape = ETAPE_ERREUR;
+                break;
+            }
+            /* plus rien n'avance sans nouvelle entrée */
+            if (f->nb_entree == 0 && d->restant_clair > 0 && f->nb_sortie > 0)
+            {
+                if (mode != HUFF_FIN)
+                {
+                    return HUFF_OK;
+                }
+                d->etape = ETAPE_ERREUR;
+            }
+            break;
+        default:
+            return HUFF_ERREUR_DONNEES;
+        }
+    }
+}
@@ -12,46 +12,182 @@
 #include "code.h"
 #include "compression.h"
 #include "decompression.h"
+#include "estimation.h"
+#include "archive.h"
+#include "verification.h"
+#include "parcours.h"
 #include "graphique.h"
 
 void usage(char *s)
 {
     printf("Programme de compression et de decompression de fichiers textes (version v5)\n\n");
     printf("Usage %s : [option] [nom_archive] [fichiers ou dossier]\n", s);
-    printf("Options :\n\t-c : compression de [fichiers ou dossier] vers une archive nom_archive\n\t-d : decompression de nom_archive vers le dossier ou les fichiers d'origine\n\t\tsi [dossier_cible] est fourni, decompression dans ce dossier sinon dans le dossier courant\n\t-h  : affiche ce menu d'aide\n\t-g : affiche le programme en versions graphique\n");
+    printf("      %s train [dictionnaire] [numero] [fichiers ou dossier] : apprend une table sur un corpus\n", s);
+    printf("      %s merge [nouvelle_archive] [archives] [-m fichier]... : reunit des archives (ou les fichiers choisis) sans recompresser\n", s);
+    printf("Options :\n\t-c : compression de [fichiers ou dossier] vers une archive nom_archive\n\t-a : ajoute [fichiers ou dossier] a la fin de l'archive nom_archive sans reecrire ses membres\n\t-d : decompression de nom_archive vers le dossier ou les fichiers d'origine\n\t\tsi [dossier_cible] est fourni, decompression dans ce dossier sinon dans le dossier courant\n\t-s : avec -c (et place avant), archive solide : une seule table pour tous les fichiers\n\t-b [Kio] : (avant -c) taille des blocs, sinon choisie d'apres le contenu\n\t--cache [fichier] : (avant -c) recopie sans les recompresser les fichiers inchanges depuis l'archive precedente\n\t-L : (avant -c) ecrit chaque fichier au format d'origine (une table par fichier, sans blocs)\n\t-D [dictionnaire] : (avant -c ou -d) charge les tables apprises avec train\n\t-i [numero] : (avant -c) code les petits fichiers avec cette table du dictionnaire\n\t-l [nom_archive] : liste les fichiers de l'archive\n\t-t [nom_archive] : teste l'archive (decode et verifie le CRC32C de chaque fichier sans rien ecrire) et mesure le debit du decodeur\n\t-x [fichier] : (avant -d) n'extrait que ce fichier de l'archive\n\t--range debut:longueur : (avec -x, avant -d) ecrit seulement cette plage du fichier sur la sortie standard\n\t-e, --estimate [fichiers ou dossier] : estime le taux de compression sans ecrire d'archive\n\t-h  : affiche ce menu d'aide\n\t-g : affiche le programme en versions graphique\n");
 }
 
-int main(int argc, char *argv[])
+/* ajoute à l les fichiers de argv[debut..argc-1], les dossiers étant parcourus récursivement */
+void liste_entrees(int argc, char *argv[], int debut, liste_chemins *l)
 {
-    /*declarations des variables*/
-    int t[256], i, opt, dossier_decompression = 0, nb_fichiers = 0, fic, indice = 0, est_dossier;
-    FILE *fichier_depart = NULL, *fichier_dest = NULL;
-    noeud *arbre_huffman[256];
-    noeud *alphabet[256];
-    char **liste_fichiers = NULL;
-    char *nom_fich_archive, *result = NULL, *nom_dossier_decompression = NULL, *nom_dossier, *dernier_slash;
-    char chemin_complet[1024], chemin_dossier[1023];
-    int taille = 256;
-    struct stat dir_stat, st = {0};
+    int i;
+    struct stat dir_stat;
+
+    for (i = debut; i < argc; i++)
+    {
+        if (stat(argv[i], &dir_stat) == 0 && S_ISDIR(dir_stat.st_mode))
+        {
+            parcourir_dossier(argv[i], l);
+        }
+        else
+        {
+            ajouter_chemin(l, argv[i]);
+        }
+    }
+}
+
+/* affiche la taille compressée prédite de chaque fichier et le taux global, sans rien compresser */
+void estimation_entrees(char **liste_fichiers, int nb_fichiers)
+{
+    int fic;
+    long total = 0, total_estime = 0;
+    estimation e;
+
+    printf("%-40s %12s %8s %12s %7s %8s\n", "fichier", "taille", "entropie", "estimation", "taux", "bloc");
+    for (fic = 0; fic < nb_fichiers; fic++)
+    {
+        if (estimer_fichier(liste_fichiers[fic], &e) != 0)
+        {
+            printf("Impossible d'ouvrir le fichier %s\n", liste_fichiers[fic]);
+            continue;
+        }
+        /* un fichier stocké coûte sa taille */
+        if (e.stocker)
+        {
+            e.taille_estimee = e.taille;
+        }
+        printf("%-40s %12ld %8.3f %12ld %6.1f%% %7ldK%s\n", liste_fichiers[fic], e.taille, e.entropie, e.taille_estimee,
+               e.taille > 0 ? 100.0 * e.taille_estimee / e.taille : 100.0, e.taille_bloc / 1024, e.stocker ? " (stocke)" : "");
+        total += e.taille;
+        total_estime += e.taille_estimee;
+    }
+    printf("%-40s %12ld %8s %12ld %6.1f%%\n", "total", total, "", total_estime, total > 0 ? 100.0 * total_estime / total : 100.0);
+}
 
-    liste_fichiers = (char **)malloc(MAX_FICHIERS * sizeof(char *));
-    if (liste_fichiers == NULL)
+/* huffman train dictionnaire numéro [fichiers ou dossier] : ajoute ou remplace une table du dictionnaire */
+void entrainement(int argc, char *argv[])
+{
+    int id;
+    dictionnaire dico;
+    liste_chemins l;
+
+    if (argc < 5 || (id = atoi(argv[3])) < 0 || id >= NB_MAX_TABLES)
+    {
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if (charger_dictionnaire(argv[2], &dico) != 0)
+    {
+        printf("Erreur de lecture du dictionnaire %s\n", argv[2]);
+        exit(EXIT_FAILURE);
+    }
+    if (dico.tables[id] == NULL && (dico.tables[id] = (table_codes *)malloc(sizeof(table_codes))) == NULL)
     {
         printf("Erreur d'allocation memoire\n");
         exit(EXIT_FAILURE);
     }
-    for (i = 0; i < 100; i++)
+    init_liste(&l);
+    liste_entrees(argc, argv, 4, &l);
+    entrainer_table(l.chemins, l.nb, dico.tables[id]);
+    if (sauver_dictionnaire(argv[2], &dico) != 0)
+    {
+        printf("Erreur d'ecriture du dictionnaire %s\n", argv[2]);
+        exit(EXIT_FAILURE);
+    }
+    printf("Table %d apprise sur %d fichiers et enregistree dans %s\n", id, l.nb, argv[2]);
+    liberer_liste(&l);
+    liberer_dictionnaire(&dico);
+}
+
+/* huffman merge nouvelle_archive archive... [-m fichier]... : réunit des archives sans recompresser leurs membres */
+void fusion(int argc, char *argv[])
+{
+    char **archives, **selection, temporaire[1024];
+    int i, nb_archives = 0, nb_selection = 0;
+    repertoire r;
+    FILE *fichier_dest;
+
+    init_repertoire(&r);
+    archives = (char **)malloc(argc * sizeof(char *));
+    selection = (char **)malloc(argc * sizeof(char *));
+    if (argc < 4 || archives == NULL || selection == NULL)
     {
-        liste_fichiers[i] = (char *)malloc(100 * sizeof(char));
-        if (liste_fichiers[i] == NULL)
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    for (i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
         {
-            printf("Erreur d'allocation memoire\n");
-            exit(EXIT_FAILURE);
+            selection[nb_selection++] = argv[++i];
+        }
+        else
+        {
+            archives[nb_archives++] = argv[i];
         }
     }
+    /* l'archive est écrite à côté puis renommée : une erreur ne laisse jamais argv[2] à moitié écrite */
+    snprintf(temporaire, sizeof(temporaire), "%s.tmp", argv[2]);
+    if ((fichier_dest = fopen(temporaire, "w+")) == NULL)
+    {
+        printf("erreur de l'ouverture du fichier_dest\n");
+        exit(EXIT_FAILURE);
+    }
+    if (fusionner_archives(fichier_dest, archives, nb_archives, selection, nb_selection, &r) != 0)
+    {
+        printf("Erreur lors de la copie des membres\n");
+        fclose(fichier_dest);
+        remove(temporaire);
+        exit(EXIT_FAILURE);
+    }
+    ecrire_repertoire(fichier_dest, &r);
+    if (fclose(fichier_dest) != 0 || rename(temporaire, argv[2]) != 0)
+    {
+        printf("Erreur lors de l'ecriture de %s\n", argv[2]);
+        remove(temporaire);
+        exit(EXIT_FAILURE);
+    }
+    printf("%d fichiers de %d archives reunis dans %s\n", r.nb, nb_archives, argv[2]);
+    liberer_repertoire(&r);
+    free(archives);
+    free(selection);
+}
 
-    nom_fich_archive = (char *)malloc(100 * sizeof(char));
-    nom_dossier = (char *)malloc(20 * sizeof(char));
+int main(int argc, char *argv[])
+{
+    /*declarations des variables*/
+    int i, opt, fic, nb_lot, solide = 0, erreur;
+    options_compression o = {0, 0, NULL, -1, NULL};
+    extraction x;
+    repertoire r;
+    dictionnaire dico = {{NULL}};
+    FILE *fichier_depart = NULL, *fichier_dest = NULL;
+    liste_chemins l;
+    char *nom_fich_archive, *nom_membre = NULL;
+    char *nom_cache = NULL;
+    long debut_plage = 0, longueur_plage = -1;
+    prelecture p;
+    ordonnanceur ord;
+    static travail_fichier travaux[NB_FICHIERS_LOT];
+    cache c;
+    static struct option options_longues[] = {
+        {"estimate", no_argument, NULL, 'e'},
+        {"range", required_argument, NULL, 'r'},
+        {"cache", required_argument, NULL, 'K'},
+        {NULL, 0, NULL, 0}};
+
+    init_repertoire(&r);
+    init_liste(&l);
 
     if (argc < 2)
     {
@@ -59,7 +195,18 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
-    while ((opt = getopt(argc, argv, "hgc:d:")) != -1)
+    if (strcmp(argv[1], "train") == 0)
+    {
+        entrainement(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+    if (strcmp(argv[1], "merge") == 0)
+    {
+        fusion(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+
+    while ((opt = getopt_long(argc, argv, "hgesLa:c:d:D:i:b:l:t:x:", options_longues, NULL)) != -1)
     {
         switch (opt)
         {
@@ -78,118 +225,78 @@ int main(int argc, char *argv[])
                 quit_graphique(&ctx);
             }
             break;
+        case 'a':
         case 'c':
             if (argc < 4)
             {
                 usage(argv[0]);
                 exit(EXIT_FAILURE);
             }
-            nb_fichiers = argc - 3;
-            if (nb_fichiers > 100)
+            if (o.id_table >= 0 && (solide || o.id_table >= NB_MAX_TABLES || dico.tables[o.id_table] == NULL))
             {
-                printf("Erreur : trop de fichiers\n");
+                printf("Erreur : la table %d n'est pas dans le dictionnaire (-D) ou -i est utilise avec -s\n", o.id_table);
                 exit(EXIT_FAILURE);
             }
-            sprintf(nom_fich_archive, "%s", optarg);
-            /* mettre une boucle pour tous les fichiers */
-            for (i = optind; i < argc; i++)
+            if (o.id_table >= 0)
             {
-                stat(argv[i], &dir_stat);
-                if (S_ISDIR(dir_stat.st_mode))
-                {
-                    /* on est dans un répertoire */
-                    if ((nb_fichiers = compter_elements_dossier(argv[i])) > MAX_FICHIERS)
-                    {
-                        printf("Erreur : trop de fichiers dans le dossier\n");
-                        exit(EXIT_FAILURE);
-                    }
-                    sprintf(nom_dossier, "%s", argv[i]);
-
-                    lecture_dossier(nom_dossier, liste_fichiers, &indice);
-                }
-                else
+                o.table_dictionnaire = dico.tables[o.id_table];
+            }
+            nom_fich_archive = optarg;
+            liste_entrees(argc, argv, optind, &l);
+            /* le cache repère, par leurs empreintes, les fichiers inchangés depuis l'archive précédente */
+            if (!solide && nom_cache != NULL)
+            {
+                if (charger_cache(nom_cache, nom_fich_archive, &c) != 0)
                 {
-                    sprintf(liste_fichiers[indice], "%s", argv[i]);
-                    indice++;
+                    printf("Erreur de lecture du cache %s\n", nom_cache);
+                    exit(EXIT_FAILURE);
                 }
+                o.cache = &c;
             }
 
-            /* compresser tous les fichiers */
-
-            nb_fichiers = indice;
-
-            /* ouverture du fichier de destination */
-            fichier_dest = fopen(nom_fich_archive, "w+");
+            /* ouverture du fichier de destination : avec -a, les membres existants restent en place et seul le répertoire est réécrit */
+            fichier_dest = fopen(nom_fich_archive, opt == 'a' ? "r+" : "w+");
             if (fichier_dest == NULL)
             {
                 printf("erreur de l'ouverture du fichier_dest\n");
                 exit(EXIT_FAILURE);
             }
-            for (fic = 0; fic < nb_fichiers; fic++)
+            if (opt == 'a' && ouvrir_ajout(fichier_dest, &r) != 0)
             {
-                *arbre_huffman = NULL;
-                *alphabet = NULL;
-                taille = 256;
-                /*ouverture du fichier_depart*/
-                fichier_depart = fopen(liste_fichiers[fic], "r");
-                if (fichier_depart == NULL)
-                {
-                    printf("Impossible d'ouvrir le fichier_depart %s pour lecture \n", liste_fichiers[fic]);
-                    exit(EXIT_FAILURE);
-                }
-                /*fin ouverture du fichier_depart*/
-
-                occurence(fichier_depart, t);
-
-                /*fermeture du fichier_depart*/
-                if (fclose(fichier_depart) != 0)
-                {
-                    printf("Erreur lors de la fermeture de fichier_depart\n");
-                    exit(EXIT_FAILURE);
-                }
-                /*fin fermeture du fichier_depart*/
-
-                for (i = 0; i < 256; i++)
-                {
-                    arbre_huffman[i] = creer_st_noeud(i, t[i]);
-                }
-
-                /* création de l'arbre de Huffman */
-                while (taille > 1)
-                {
-                    creer_noeud(arbre_huffman, taille);
-                    taille--;
-                }
-
-                /* initialisation de l'alphabet */
-                for (i = 0; i < 256; i++)
-                {
-                    alphabet[i] = NULL;
-                }
-
-                /* affectation du codage */
-                creer_code(arbre_huffman[0], 0, 0, alphabet);
-                /* écriture de l'en-tête */
-
-                en_tete(fichier_dest, alphabet, liste_fichiers[fic]);
-
-                /*ouverture du fichier_depart*/
-                fichier_depart = fopen(liste_fichiers[fic], "r");
-                if (fichier_depart == NULL)
-                {
-                    printf("Impossible d'ouvrir le fichier_depart pour codes %s \n", liste_fichiers[fic]);
-                    exit(EXIT_FAILURE);
-                }
-                /*fin ouverture du fichier_depart*/
-
-                codes_fichier(fichier_depart, fichier_dest, alphabet);
-                fputs("\n\n\n", fichier_dest);
-
-                if (fclose(fichier_depart) != 0)
+                printf("L'archive %s n'a pas de repertoire central\n", nom_fich_archive);
+                exit(EXIT_FAILURE);
+            }
+            /* compresser tous les fichiers */
+            lancer_ordonnanceur(&ord);
+            if (solide)
+            {
+                compression_solide(fichier_dest, l.chemins, l.nb, &ord, &r);
+            }
+            else
+            {
+                /* les fichiers sont lus d'avance par lots, avec leurs empreintes, puis codés par les fils de l'ordonnanceur ;
+                   l'archive est écrite dans l'ordre de la liste */
+                init_prelecture(&p);
+                for (fic = 0; fic < l.nb; fic += nb_lot)
                 {
-                    printf("Erreur lors de la fermeture de fichier_depart\n");
-                    exit(EXIT_FAILURE);
+                    nb_lot = lire_lot(&p, l.chemins + fic, l.nb - fic);
+                    planifier_lot(&ord, p.fichiers, nb_lot, &o, &r, travaux);
+                    for (i = 0; i < nb_lot; i++)
+                    {
+                        ajouter_fichier(fichier_dest, &p.fichiers[i], &travaux[i], &o, &r);
+                        liberer_travail(&travaux[i]);
+                        avancer_lot(travaux + i + 1, nb_lot - i - 1);
+                    }
                 }
+                liberer_prelecture(&p);
+            }
+            arreter_ordonnanceur(&ord);
+            /* le répertoire central termine l'archive */
+            ecrire_repertoire(fichier_dest, &r);
+            if (tronquer_fichier(fichier_dest) != 0)
+            {
+                printf("Erreur lors de l'ecriture de %s\n", nom_fich_archive);
+                exit(EXIT_FAILURE);
             }
             printf("L'archive est disponible dans le fichier %s\n", nom_fich_archive);
             if (fclose(fichier_dest) != 0)
@@ -197,17 +304,29 @@ int main(int argc, char *argv[])
                 printf("Erreur lors de la fermeture de fichier_dest\n");
                 exit(EXIT_FAILURE);
             }
+            /* le cache désigne désormais la nouvelle archive */
+            if (o.cache != NULL)
+            {
+                liberer_cache(o.cache);
+                if (sauver_cache(nom_cache, nom_fich_archive, &r) != 0)
+                {
+                    printf("Erreur d'ecriture du cache %s\n", nom_cache);
+                }
+            }
+            liberer_repertoire(&r);
+            liberer_liste(&l);
             break;
         case 'd':
             /* décompression */
-            sprintf(nom_fich_archive, "%s", optarg);
-
-            if (argc > 3)
+            nom_fich_archive = optarg;
+            x.dico = &dico;
+            x.dossier = NULL;
+            x.renommer = NULL;
+            x.ordonnanceur = &ord;
+            if (optind < argc)
             {
-                nom_dossier_decompression = (char *)malloc(100 * sizeof(char));
-                sprintf(nom_dossier_decompression, "%s", argv[optind]);
-                printf("Dossier de destination des fichiers décompressés : %s\n", nom_dossier_decompression);
-                dossier_decompression = 1;
+                x.dossier = argv[optind];
+                printf("Dossier de destination des fichiers décompressés : %s\n", x.dossier);
             }
 
             fichier_depart = fopen(nom_fich_archive, "r");
@@ -216,99 +335,108 @@ int main(int argc, char *argv[])
                 printf("Impossible d'ouvrir le fichier_depart \n");
                 exit(EXIT_FAILURE);
             }
-
-            while (!feof(fichier_depart))
+            /* le répertoire central donne le CRC32C attendu de chaque membre */
+            lire_repertoire(fichier_depart, &x.repertoire);
+            rewind(fichier_depart);
+            lancer_ordonnanceur(&ord);
+            /* avec -x, seul le membre demandé est lu grâce au répertoire central */
+            if (nom_membre != NULL && longueur_plage >= 0)
             {
-                est_dossier = 0;
-                for (i = 0; i < 256; i++)
-                {
-                    alphabet[i] = NULL;
-                }
-                result = (char *)malloc(500 * sizeof(char));
-                if (result == NULL)
-                {
-                    printf("Erreur d'allocation de mémoire\n");
-                    exit(EXIT_FAILURE);
-                }
-
-                rec_alph_fich(fichier_depart, alphabet, &result);
-
-                /* vérifier si le nom de fichier comporte un dossier */
-                dernier_slash = strrchr(result, '/');
-                if (dernier_slash != NULL)
-                {
-                    est_dossier = 1;
-                    indice = dernier_slash - result;
-                    strncpy(nom_dossier, result, indice);
-                    nom_dossier[indice] = '\0'; /* contient le nom du dossier */
-                    result = dernier_slash + 1; /* contient le nom du fichier */
-                }
-
-                recreation_huffman(alphabet, arbre_huffman);
-
-                fichier_dest = fopen(result, "w");
-
-                decompression(fichier_depart, fichier_dest, arbre_huffman[0], alphabet);
-
-                if (fscanf(fichier_depart, "\n\n\n") != 0)
-                {
-                    printf("Erreur dans le fichier compressé\n");
-                    exit(EXIT_FAILURE);
-                }
-
-                printf("Le fichier %s a été décompressé.\n", result);
-
-                if (est_dossier)
-                {
-                    if (dossier_decompression)
-                    {
-                        if (nom_dossier_decompression[strlen(nom_dossier_decompression) - 2] == '/')
-                        {
-                            nom_dossier_decompression[strlen(nom_dossier_decompression) - 2] = '\0';
-                        }
-                        if (stat(nom_dossier_decompression, &st) == -1)
-                        {
-                            /* si le dossier n'existe pas on le créé */
-                            mkdir(nom_dossier_decompression, 0777);
-                        }
-                        sprintf(chemin_dossier, "%s/%s", nom_dossier_decompression, nom_dossier);
-                        if (stat(chemin_dossier, &st) == -1)
-                        {
-                            mkdir_p(chemin_dossier);
-                        }
-                        sprintf(chemin_complet, "%s/%s", chemin_dossier, result);
-                        rename(result, chemin_complet);
-                    }
-                    else
-                    {
-                        if (stat(nom_dossier, &st) == -1)
-                        {
-                            /* si le dossier n'existe pas */
-                            mkdir_p(nom_dossier);
-                            /* création du dossier */
-                        }
-                        sprintf(chemin_complet, "%s/%s", nom_dossier, result);
-                        rename(result, chemin_complet);
-                    }
-                }
-
-                if (fclose(fichier_dest) != 0)
+                /* --range : la plage est écrite sur la sortie standard */
+                erreur = extraire_plage(fichier_depart, nom_membre, debut_plage, longueur_plage, stdout, &x);
+            }
+            else if (nom_membre != NULL)
+            {
+                erreur = extraire_selection(fichier_depart, nom_membre, &x);
+            }
+            else
+            {
+                while ((erreur = extraire_membre(fichier_depart, &x)) == 0)
                 {
-                    printf("Erreur lors de la fermeture de fichier_dest\n");
-                    exit(EXIT_FAILURE);
                 }
             }
+            arreter_ordonnanceur(&ord);
+            liberer_repertoire(&x.repertoire);
+            if (erreur < 0)
+            {
+                exit(EXIT_FAILURE);
+            }
             if (fclose(fichier_depart) != 0)
             {
                 printf("Erreur lors de la fermeture de fichier_depart\n");
                 exit(EXIT_FAILURE);
             }
             break;
+        case 't':
+            if (tester_archive(optarg, &dico) != 0)
+            {
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'l':
+            fichier_depart = fopen(optarg, "r");
+            if (fichier_depart == NULL)
+            {
+                printf("Impossible d'ouvrir le fichier_depart \n");
+                exit(EXIT_FAILURE);
+            }
+            if (lister_archive(fichier_depart) != 0)
+            {
+                exit(EXIT_FAILURE);
+            }
+            fclose(fichier_depart);
+            break;
+        case 'x':
+            nom_membre = optarg;
+            break;
+        case 'K':
+            nom_cache = optarg;
+            break;
+        case 'r':
+            if (sscanf(optarg, "%ld:%ld", &debut_plage, &longueur_plage) != 2 || debut_plage < 0 || longueur_plage < 0)
+            {
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 's':
+            solide = 1;
+            break;
+        case 'L':
+            o.format_origine = 1;
+            break;
+        case 'b':
+            if ((o.taille_bloc = atol(optarg) * 1024) <= 0)
+            {
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'D':
+            if (charger_dictionnaire(optarg, &dico) != 0)
+            {
+                printf("Erreur de lecture du dictionnaire %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'i':
+            o.id_table = atoi(optarg);
+            break;
+        case 'e':
+            if (optind >= argc)
+            {
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            liste_entrees(argc, argv, optind, &l);
+            estimation_entrees(l.chemins, l.nb);
+            break;
         case '?':
             usage(argv[0]);
             exit(EXIT_FAILURE);
         }
     }
 
+    liberer_dictionnaire(&dico);
     exit(EXIT_SUCCESS);
 }
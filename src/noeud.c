@@ -90,11 +90,10 @@ void deux_plus_petits(int tab[], int taille, int *p1, int *p2)
   }
 }
 
-void creer_noeud(noeud *tab[], int taille)
+int creer_noeud_dans(noeud *tab[], int taille, noeud *n)
 {
-  int p1, p2, i;
+  int p1, p2, i, cree = 0;
   int tab_occurrences[256];
-  noeud *n;
   /* Vérifie si le tableau est non nul et si la taille est positive */
   for (i = 0; i < taille; i++)
   {
@@ -107,12 +106,16 @@ void creer_noeud(noeud *tab[], int taille)
   {
     if (tab[p2]->occurence != 0)
     {
-      n = creer_st_noeud(tab[p1]->occurence + tab[p2]->occurence, tab[p1]->occurence + tab[p2]->occurence);
+      n->occurence = tab[p1]->occurence + tab[p2]->occurence;
+      n->caractere = (char)n->occurence;
+      n->codage = 0;
+      n->nbr_bits = 0;
       n->f_gauche = tab[p2];
       n->f_droit = tab[p1];
       tab[p2]->codage = 0;
       tab[p1]->codage = 1;
       tab[p1] = n;
+      cree = 1;
     }
     /* suppression du noeud p2 dans le tableau => si occurence = 0 ou comme on a créé un nouveau noeud */
     for (i = p2; i < taille - 1; i++)
@@ -128,6 +131,17 @@ void creer_noeud(noeud *tab[], int taille)
       tab[i] = tab[i + 1];
     }
   }
+  return cree;
+}
+
+void creer_noeud(noeud *tab[], int taille)
+{
+  noeud *n = creer_st_noeud(0, 0);
+
+  if (!creer_noeud_dans(tab, taille, n))
+  {
+    free(n);
+  }
 }
 
 /* Fonction pour libérer récursivement un arbre Huffman */
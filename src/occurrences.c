@@ -51,3 +51,17 @@ void occurence(FILE *fic, int tab[])
         }
     } */
 }
+
+void occurence_tampon(const unsigned char *tampon, size_t taille, long tab[])
+{
+    size_t i;
+
+    for (i = 0; i < 256; i++)
+    {
+        tab[i] = 0;
+    }
+    for (i = 0; i < taille; i++)
+    {
+        tab[tampon[i]]++;
+    }
+}
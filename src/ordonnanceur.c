@@ -0,0 +1,213 @@
+#include "ordonnanceur.h"
+
+static tache *prendre(deque_taches *d)
+{
+    tache *t = NULL;
+    pthread_mutex_lock(&d->verrou);
+    if (d->debut < d->fin)
+    {
+        t = d->taches[d->debut++];
+    }
+    pthread_mutex_unlock(&d->verrou);
+    return t;
+}
+
+/* vole la dernière tâche de la file la plus chargée des autres fils ;
+   nb_fils n'est lu que par le fil principal, les files des fils non lancés restent vides */
+static tache *voler(ordonnanceur *o, int voleur)
+{
+    tache *t = NULL;
+    deque_taches *d;
+    int i, victime = -1, nb, nb_max = 0;
+
+    for (i = 0; i < NB_MAX_FILS; i++)
+    {
+        d = &o->deques[i];
+        pthread_mutex_lock(&d->verrou);
+        nb = d->fin - d->debut;
+        pthread_mutex_unlock(&d->verrou);
+        if (i != voleur && nb > nb_max)
+        {
+            nb_max = nb;
+            victime = i;
+        }
+    }
+    if (victime < 0)
+    {
+        return NULL;
+    }
+    d = &o->deques[victime];
+    pthread_mutex_lock(&d->verrou);
+    if (d->debut < d->fin)
+    {
+        t = d->taches[--d->fin];
+    }
+    pthread_mutex_unlock(&d->verrou);
+    return t;
+}
+
+static void *fil_taches(void *arg)
+{
+    fil_ordonnanceur *f = (fil_ordonnanceur *)arg;
+    ordonnanceur *o = f->o;
+    tache *t;
+
+    for (;;)
+    {
+        if ((t = prendre(&o->deques[f->numero])) == NULL)
+        {
+            t = voler(o, f->numero);
+        }
+        pthread_mutex_lock(&o->verrou);
+        if (t == NULL)
+        {
+            /* rien à prendre : dort jusqu'à la prochaine soumission, ou s'arrête s'il n'y en aura plus */
+            if (o->nb_en_file == 0 && o->arret)
+            {
+                pthread_mutex_unlock(&o->verrou);
+                return NULL;
+            }
+            if (o->nb_en_file == 0)
+            {
+                pthread_cond_wait(&o->travail, &o->verrou);
+            }
+            pthread_mutex_unlock(&o->verrou);
+            continue;
+        }
+        o->nb_en_file--;
+        pthread_mutex_unlock(&o->verrou);
+
+        t->executer(t);
+
+        pthread_mutex_lock(&o->verrou);
+        t->finie = 1;
+        pthread_cond_broadcast(&o->termine);
+        pthread_mutex_unlock(&o->verrou);
+    }
+}
+
+void lancer_ordonnanceur(ordonnanceur *o)
+{
+    int i, nb = nb_fils_disponibles();
+
+    o->nb_fils = 0;
+    o->suivant = 0;
+    o->nb_en_file = 0;
+    o->arret = 0;
+    pthread_mutex_init(&o->verrou, NULL);
+    pthread_cond_init(&o->travail, NULL);
+    pthread_cond_init(&o->termine, NULL);
+    for (i = 0; i < NB_MAX_FILS; i++)
+    {
+        o->deques[i].taches = NULL;
+        o->deques[i].debut = o->deques[i].fin = o->deques[i].capacite = 0;
+        pthread_mutex_init(&o->deques[i].verrou, NULL);
+        o->arguments[i].o = o;
+        o->arguments[i].numero = i;
+    }
+    for (i = 0; i < nb; i++)
+    {
+        if (pthread_create(&o->fils[i], NULL, fil_taches, &o->arguments[i]) != 0)
+        {
+            break;
+        }
+        o->nb_fils++;
+    }
+}
+
+static int comparer_couts(const void *a, const void *b)
+{
+    const tache *ta = *(tache *const *)a, *tb = *(tache *const *)b;
+    if (ta->cout != tb->cout)
+    {
+        return ta->cout < tb->cout ? 1 : -1;
+    }
+    return ta->ordre - tb->ordre;
+}
+
+static void empiler(deque_taches *d, tache *t)
+{
+    pthread_mutex_lock(&d->verrou);
+    /* place libérée au début par le propriétaire */
+    if (d->debut > 0 && d->fin == d->capacite)
+    {
+        memmove(d->taches, d->taches + d->debut, (d->fin - d->debut) * sizeof(tache *));
+        d->fin -= d->debut;
+        d->debut = 0;
+    }
+    if (d->fin == d->capacite)
+    {
+        d->capacite = d->capacite == 0 ? 64 : 2 * d->capacite;
+        if ((d->taches = (tache **)realloc(d->taches, d->capacite * sizeof(tache *))) == NULL)
+        {
+            printf("Erreur d'allocation memoire\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    d->taches[d->fin++] = t;
+    pthread_mutex_unlock(&d->verrou);
+}
+
+void soumettre_taches(ordonnanceur *o, tache *taches[], int nb)
+{
+    int i;
+
+    for (i = 0; i < nb; i++)
+    {
+        taches[i]->ordre = i;
+        taches[i]->finie = 0;
+    }
+    /* aucun fil n'a pu démarrer : les tâches sont faites ici, tout de suite */
+    if (o->nb_fils == 0)
+    {
+        for (i = 0; i < nb; i++)
+        {
+            taches[i]->executer(taches[i]);
+            taches[i]->finie = 1;
+        }
+        return;
+    }
+    qsort(taches, nb, sizeof(tache *), comparer_couts);
+    /* compte et tâches changent sous le même verrou : un fil qui prend une tâche ne la décompte qu'après son ajout au compte */
+    pthread_mutex_lock(&o->verrou);
+    o->nb_en_file += nb;
+    for (i = 0; i < nb; i++)
+    {
+        empiler(&o->deques[o->suivant], taches[i]);
+        o->suivant = (o->suivant + 1) % o->nb_fils;
+    }
+    pthread_cond_broadcast(&o->travail);
+    pthread_mutex_unlock(&o->verrou);
+}
+
+void attendre_tache(ordonnanceur *o, tache *t)
+{
+    pthread_mutex_lock(&o->verrou);
+    while (!t->finie)
+    {
+        pthread_cond_wait(&o->termine, &o->verrou);
+    }
+    pthread_mutex_unlock(&o->verrou);
+}
+
+void arreter_ordonnanceur(ordonnanceur *o)
+{
+    int i;
+
+    pthread_mutex_lock(&o->verrou);
+    o->arret = 1;
+    pthread_cond_broadcast(&o->travail);
+    pthread_mutex_unlock(&o->verrou);
+    for (i = 0; i < o->nb_fils; i++)
+    {
+        pthread_join(o->fils[i], NULL);
+    }
+    for (i = 0; i < NB_MAX_FILS; i++)
+    {
+        free(o->deques[i].taches);
+        pthread_mutex_destroy(&o->deques[i].verrou);
+    }
+    pthread_mutex_destroy(&o->verrou);
+    pthread_cond_destroy(&o->travail);
+    pthread_cond_destroy(&o->termine);
+}
@@ -0,0 +1,351 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "parcours.h"
+
+void init_liste(liste_chemins *l)
+{
+    l->chemins = NULL;
+    l->nb = l->capacite = 0;
+    l->arene = NULL;
+}
+
+/* réserve n octets dans l'arène de l */
+static char *reserver(liste_chemins *l, size_t n)
+{
+    bloc_arene *bloc = l->arene;
+    size_t taille;
+    char *place;
+
+    if (bloc == NULL || bloc->utilise + n > bloc->taille)
+    {
+        /* un chemin plus long qu'un bloc a son propre bloc */
+        taille = n > TAILLE_BLOC_ARENE ? n : TAILLE_BLOC_ARENE;
+        if ((bloc = (bloc_arene *)malloc(sizeof(bloc_arene) + taille)) == NULL)
+        {
+            printf("Erreur d'allocation memoire\n");
+            exit(EXIT_FAILURE);
+        }
+        bloc->precedent = l->arene;
+        bloc->utilise = 0;
+        bloc->taille = taille;
+        l->arene = bloc;
+    }
+    place = bloc->donnees + bloc->utilise;
+    bloc->utilise += n;
+    return place;
+}
+
+char *copier_chemin(liste_chemins *l, const char *s, size_t n)
+{
+    char *copie = reserver(l, n + 1);
+    memcpy(copie, s, n);
+    copie[n] = '\0';
+    return copie;
+}
+
+static void ajouter_pointeur(liste_chemins *l, char *chemin)
+{
+    if (l->nb == l->capacite)
+    {
+        l->capacite = l->capacite == 0 ? 1024 : 2 * l->capacite;
+        if ((l->chemins = (char **)realloc(l->chemins, l->capacite * sizeof(char *))) == NULL)
+        {
+            printf("Erreur d'allocation memoire\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    l->chemins[l->nb++] = chemin;
+}
+
+void ajouter_chemin(liste_chemins *l, const char *chemin)
+{
+    ajouter_pointeur(l, copier_chemin(l, chemin, strlen(chemin)));
+}
+
+/* ajoute à l les chemins de autre et récupère son arène */
+static void reunir(liste_chemins *l, liste_chemins *autre)
+{
+    bloc_arene *bloc;
+    int i;
+
+    for (i = 0; i < autre->nb; i++)
+    {
+        ajouter_pointeur(l, autre->chemins[i]);
+    }
+    if (autre->arene != NULL)
+    {
+        for (bloc = autre->arene; bloc->precedent != NULL; bloc = bloc->precedent)
+        {
+        }
+        bloc->precedent = l->arene;
+        l->arene = autre->arene;
+    }
+    free(autre->chemins);
+    init_liste(autre);
+}
+
+/* file commune des dossiers à parcourir */
+typedef struct file_dossiers
+{
+    char **dossiers;
+    int nb, capacite;
+    int en_attente, nb_fils;   /* fils qui attendent du travail ; quand ils attendent tous, le parcours est fini */
+    pthread_mutex_t verrou;
+    pthread_cond_t travail;
+} file_dossiers;
+
+/* chaque fil range ses chemins (fichiers trouvés et dossiers confiés à la file) dans sa propre liste */
+typedef struct fil_parcours
+{
+    file_dossiers *file;
+    liste_chemins trouves;
+    liste_chemins pile;   /* sous-dossiers trop profonds pour être ouverts tout de suite, chemins dans l'arène de trouves */
+} fil_parcours;
+
+static void confier(file_dossiers *f, char *dossier)
+{
+    pthread_mutex_lock(&f->verrou);
+    if (f->nb == f->capacite)
+    {
+        f->capacite = f->capacite == 0 ? 256 : 2 * f->capacite;
+        if ((f->dossiers = (char **)realloc(f->dossiers, f->capacite * sizeof(char *))) == NULL)
+        {
+            printf("Erreur d'allocation memoire\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    f->dossiers[f->nb++] = dossier;
+    pthread_cond_signal(&f->travail);
+    pthread_mutex_unlock(&f->verrou);
+}
+
+/* vrai si des fils attendent et que la file ne suffit pas à les occuper */
+static int file_affamee(file_dossiers *f)
+{
+    int affamee;
+    pthread_mutex_lock(&f->verrou);
+    affamee = f->en_attente > f->nb;
+    pthread_mutex_unlock(&f->verrou);
+    return affamee;
+}
+
+/* parcourt le dossier ouvert fd, de chemin chemin, qui est à profondeur niveaux du dernier dossier ouvert par son chemin ;
+   fd est fermé à la fin. Les sous-dossiers sont ouverts avec openat depuis fd, sans refaire résoudre tout le chemin, tant
+   que le fil n'a pas PROFONDEUR_OUVERTE dossiers ouverts ; au-delà, ils attendent sur la pile du fil */
+static void parcourir(fil_parcours *p, int fd, char *chemin, int profondeur)
+{
+    DIR *dossier;
+    struct dirent *ent;
+    struct stat st;
+    size_t longueur = strlen(chemin), longueur_nom;
+    int type, fd_sous_dossier;
+    char *complet;
+
+    if ((dossier = fdopendir(fd)) == NULL)
+    {
+        close(fd);
+        return;
+    }
+    while ((ent = readdir(dossier)) != NULL)
+    {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+        {
+            continue;
+        }
+        type = ent->d_type;
+        /* d_type évite un stat par entrée ; quand il n'est pas renseigné, l'entrée elle-même est examinée, sans suivre un lien */
+        if (type == DT_UNKNOWN)
+        {
+            if (fstatat(fd, ent->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+            {
+                continue;
+            }
+            type = S_ISREG(st.st_mode) ? DT_REG : S_ISDIR(st.st_mode) ? DT_DIR : S_ISLNK(st.st_mode) ? DT_LNK : DT_UNKNOWN;
+        }
+        /* un lien se juge par sa cible : vers un fichier, il est archivé ; vers un dossier, il n'est pas suivi, pour ne pas boucler */
+        if (type == DT_LNK)
+        {
+            if (fstatat(fd, ent->d_name, &st, 0) != 0 || !S_ISREG(st.st_mode))
+            {
+                continue;
+            }
+            type = DT_REG;
+        }
+        if (type != DT_REG && type != DT_DIR)
+        {
+            continue;
+        }
+        longueur_nom = strlen(ent->d_name);
+        complet = reserver(&p->trouves, longueur + longueur_nom + 2);
+        memcpy(complet, chemin, longueur);
+        complet[longueur] = '/';
+        memcpy(complet + longueur + 1, ent->d_name, longueur_nom + 1);
+        if (type == DT_REG)
+        {
+            ajouter_pointeur(&p->trouves, complet);
+        }
+        else if (file_affamee(p->file))
+        {
+            confier(p->file, complet);
+        }
+        else if (profondeur + 1 >= PROFONDEUR_OUVERTE)
+        {
+            ajouter_pointeur(&p->pile, complet);
+        }
+        else if ((fd_sous_dossier = openat(fd, ent->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW)) >= 0)
+        {
+            parcourir(p, fd_sous_dossier, complet, profondeur + 1);
+        }
+    }
+    closedir(dossier);
+}
+
+/* ouvre dossier par son chemin et le parcourt */
+static void parcourir_chemin(fil_parcours *p, char *dossier)
+{
+    int fd;
+    if ((fd = open(dossier, O_RDONLY | O_DIRECTORY)) >= 0)
+    {
+        parcourir(p, fd, dossier, 0);
+    }
+}
+
+/* parcourt l'arborescence dossier puis les dossiers laissés sur la pile du fil ; un fil qui attend reçoit ceux de la pile */
+static void parcourir_arborescence(fil_parcours *p, char *dossier)
+{
+    parcourir_chemin(p, dossier);
+    while (p->pile.nb > 0)
+    {
+        dossier = p->pile.chemins[--p->pile.nb];
+        if (file_affamee(p->file))
+        {
+            confier(p->file, dossier);
+        }
+        else
+        {
+            parcourir_chemin(p, dossier);
+        }
+    }
+}
+
+static void *fil_dossiers(void *arg)
+{
+    fil_parcours *p = (fil_parcours *)arg;
+    file_dossiers *f = p->file;
+    char *dossier;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&f->verrou);
+        f->en_attente++;
+        while (f->nb == 0 && f->en_attente < f->nb_fils)
+        {
+            pthread_cond_wait(&f->travail, &f->verrou);
+        }
+        if (f->nb == 0)
+        {
+            /* tous les fils attendent et la file est vide : réveille les autres et s'arrête */
+            pthread_cond_broadcast(&f->travail);
+            pthread_mutex_unlock(&f->verrou);
+            return NULL;
+        }
+        dossier = f->dossiers[--f->nb];
+        f->en_attente--;
+        pthread_mutex_unlock(&f->verrou);
+        parcourir_arborescence(p, dossier);
+    }
+}
+
+static int comparer_chemins(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+void parcourir_dossier(char *racine, liste_chemins *l)
+{
+    file_dossiers f;
+    fil_parcours *fils;
+    pthread_t *ids;
+    size_t longueur = strlen(racine);
+    int i, nb_lances, debut = l->nb;
+
+    /* la racine sans '/' final, les chemins trouvés en ajoutent un */
+    while (longueur > 1 && racine[longueur - 1] == '/')
+    {
+        longueur--;
+    }
+    f.dossiers = NULL;
+    f.nb = f.capacite = 0;
+    f.en_attente = 0;
+    f.nb_fils = nb_fils_disponibles();
+    pthread_mutex_init(&f.verrou, NULL);
+    pthread_cond_init(&f.travail, NULL);
+    fils = (fil_parcours *)malloc(f.nb_fils * sizeof(fil_parcours));
+    ids = (pthread_t *)malloc(f.nb_fils * sizeof(pthread_t));
+    if (fils == NULL || ids == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    confier(&f, copier_chemin(l, racine, longueur));
+
+    for (nb_lances = 0; nb_lances < f.nb_fils; nb_lances++)
+    {
+        fils[nb_lances].file = &f;
+        init_liste(&fils[nb_lances].trouves);
+        init_liste(&fils[nb_lances].pile);
+        if (pthread_create(&ids[nb_lances], NULL, fil_dossiers, &fils[nb_lances]) != 0)
+        {
+            break;
+        }
+    }
+    if (nb_lances == 0)
+    {
+        f.nb_fils = 1;
+        fils[0].file = &f;
+        init_liste(&fils[0].trouves);
+        init_liste(&fils[0].pile);
+        fil_dossiers(&fils[0]);
+        nb_lances = 1;
+    }
+    else
+    {
+        /* les fils qui n'ont pas pu démarrer ne comptent pas pour la fin du parcours */
+        pthread_mutex_lock(&f.verrou);
+        f.nb_fils = nb_lances;
+        pthread_cond_broadcast(&f.travail);
+        pthread_mutex_unlock(&f.verrou);
+        for (i = 0; i < nb_lances; i++)
+        {
+            pthread_join(ids[i], NULL);
+        }
+    }
+    for (i = 0; i < nb_lances; i++)
+    {
+        reunir(l, &fils[i].trouves);
+        liberer_liste(&fils[i].pile);
+    }
+    /* l'ordre des fils n'est pas reproductible : les chemins sont triés pour que l'archive le soit */
+    qsort(l->chemins + debut, l->nb - debut, sizeof(char *), comparer_chemins);
+
+    pthread_mutex_destroy(&f.verrou);
+    pthread_cond_destroy(&f.travail);
+    free(f.dossiers);
+    free(fils);
+    free(ids);
+}
+
+void liberer_liste(liste_chemins *l)
+{
+    bloc_arene *bloc;
+    while ((bloc = l->arene) != NULL)
+    {
+        l->arene = bloc->precedent;
+        free(bloc);
+    }
+    free(l->chemins);
+    init_liste(l);
+}
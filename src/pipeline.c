@@ -0,0 +1,308 @@
+#define _GNU_SOURCE
+#include <limits.h>
+#include <sched.h>
+#include "pipeline.h"
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+/* quelques tours avant de s'endormir : l'autre étape a souvent presque fini */
+#define NB_TOURS_ATTENTE 64
+
+/* signale un changement à l'étape qui attend peut-être de l'autre côté */
+static void signaler(anneau *a)
+{
+    __atomic_add_fetch(&a->sequence, 1, __ATOMIC_SEQ_CST);
+#ifdef __linux__
+    if (__atomic_load_n(&a->nb_en_attente, __ATOMIC_SEQ_CST) > 0)
+    {
+        syscall(SYS_futex, &a->sequence, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+    }
+#endif
+}
+
+/* prochain tampon à produire (pour_producteur) ou à consommer ; -1 à la fin ou à l'abandon */
+static int pret(anneau *a, int pour_producteur)
+{
+    unsigned tete = __atomic_load_n(&a->tete, __ATOMIC_SEQ_CST);
+    unsigned queue = __atomic_load_n(&a->queue, __ATOMIC_SEQ_CST);
+
+    if (pour_producteur)
+    {
+        if (__atomic_load_n(&a->abandon, __ATOMIC_SEQ_CST))
+        {
+            return -1;
+        }
+        return queue - tete < NB_TAMPONS_ANNEAU ? 1 : 0;
+    }
+    if (queue != tete)
+    {
+        return 1;
+    }
+    return __atomic_load_n(&a->fini, __ATOMIC_SEQ_CST) ? -1 : 0;
+}
+
+/* attend que l'anneau soit prêt ; retourne 1 ou -1 comme pret */
+static int attendre(anneau *a, int pour_producteur)
+{
+    unsigned sequence;
+    int i, etat;
+
+    for (i = 0; i < NB_TOURS_ATTENTE; i++)
+    {
+        if ((etat = pret(a, pour_producteur)) != 0)
+        {
+            return etat;
+        }
+    }
+    for (;;)
+    {
+        sequence = __atomic_load_n(&a->sequence, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&a->nb_en_attente, 1, __ATOMIC_SEQ_CST);
+        if ((etat = pret(a, pour_producteur)) != 0)
+        {
+            __atomic_sub_fetch(&a->nb_en_attente, 1, __ATOMIC_SEQ_CST);
+            return etat;
+        }
+#ifdef __linux__
+        /* ne dort pas si un événement a eu lieu depuis la lecture de sequence */
+        syscall(SYS_futex, &a->sequence, FUTEX_WAIT_PRIVATE, sequence, NULL, NULL, 0);
+#else
+        (void)sequence;
+        sched_yield();
+#endif
+        __atomic_sub_fetch(&a->nb_en_attente, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+static void init_anneau(anneau *a)
+{
+    if ((a->memoire = (unsigned char *)malloc((size_t)NB_TAMPONS_ANNEAU * TAILLE_TAMPON_ANNEAU)) == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    a->tete = a->queue = 0;
+    a->fini = a->abandon = 0;
+    a->sequence = 0;
+    a->nb_en_attente = 0;
+}
+
+unsigned char *tampon_libre(anneau *a)
+{
+    if (attendre(a, 1) < 0)
+    {
+        return NULL;
+    }
+    return a->memoire + (size_t)(a->queue % NB_TAMPONS_ANNEAU) * TAILLE_TAMPON_ANNEAU;
+}
+
+void publier(anneau *a, size_t taille)
+{
+    a->tailles[a->queue % NB_TAMPONS_ANNEAU] = taille;
+    __atomic_store_n(&a->queue, a->queue + 1, __ATOMIC_SEQ_CST);
+    signaler(a);
+}
+
+void clore(anneau *a)
+{
+    __atomic_store_n(&a->fini, 1, __ATOMIC_SEQ_CST);
+    signaler(a);
+}
+
+unsigned char *tampon_plein(anneau *a, size_t *taille)
+{
+    if (attendre(a, 0) < 0)
+    {
+        return NULL;
+    }
+    *taille = a->tailles[a->tete % NB_TAMPONS_ANNEAU];
+    return a->memoire + (size_t)(a->tete % NB_TAMPONS_ANNEAU) * TAILLE_TAMPON_ANNEAU;
+}
+
+void rendre(anneau *a)
+{
+    __atomic_store_n(&a->tete, a->tete + 1, __ATOMIC_SEQ_CST);
+    signaler(a);
+}
+
+void abandonner(anneau *a)
+{
+    __atomic_store_n(&a->abandon, 1, __ATOMIC_SEQ_CST);
+    signaler(a);
+}
+
+size_t lire_flux(flux *f, void *dst, size_t n)
+{
+    size_t lu = 0, k;
+
+    if (f->a == NULL)
+    {
+        return fread(dst, 1, n, f->fic);
+    }
+    while (lu < n)
+    {
+        if (f->pos == f->taille)
+        {
+            if (f->tampon != NULL)
+            {
+                rendre(f->a);
+            }
+            f->pos = 0;
+            if ((f->tampon = tampon_plein(f->a, &f->taille)) == NULL)
+            {
+                f->taille = 0;
+                break;
+            }
+            continue;
+        }
+        k = f->taille - f->pos < n - lu ? f->taille - f->pos : n - lu;
+        memcpy((unsigned char *)dst + lu, f->tampon + f->pos, k);
+        f->pos += k;
+        lu += k;
+    }
+    return lu;
+}
+
+void ecrire_flux(flux *f, const void *src, size_t n)
+{
+    size_t k;
+
+    if (f->a == NULL)
+    {
+        if (f->fic != NULL)
+        {
+            fwrite(src, 1, n, f->fic);
+        }
+        return;
+    }
+    while (n > 0)
+    {
+        if (f->tampon == NULL)
+        {
+            f->pos = 0;
+            if ((f->tampon = tampon_libre(f->a)) == NULL)
+            {
+                return;
+            }
+        }
+        k = TAILLE_TAMPON_ANNEAU - f->pos < n ? TAILLE_TAMPON_ANNEAU - f->pos : n;
+        memcpy(f->tampon + f->pos, src, k);
+        f->pos += k;
+        src = (const unsigned char *)src + k;
+        n -= k;
+        if (f->pos == TAILLE_TAMPON_ANNEAU)
+        {
+            publier(f->a, f->pos);
+            f->tampon = NULL;
+        }
+    }
+}
+
+static void *fil_lecteur(void *arg)
+{
+    pipeline *p = (pipeline *)arg;
+    unsigned char *tampon;
+    size_t n;
+
+    while ((tampon = tampon_libre(&p->entree)) != NULL)
+    {
+        n = p->lire != NULL ? p->lire(p->src, tampon, TAILLE_TAMPON_ANNEAU, p->etat) : fread(tampon, 1, TAILLE_TAMPON_ANNEAU, p->src);
+        if (n == 0)
+        {
+            break;
+        }
+        publier(&p->entree, n);
+    }
+    clore(&p->entree);
+    return NULL;
+}
+
+static void *fil_ecrivain(void *arg)
+{
+    pipeline *p = (pipeline *)arg;
+    unsigned char *tampon;
+    size_t n;
+
+    while ((tampon = tampon_plein(&p->sortie, &n)) != NULL)
+    {
+        if (fwrite(tampon, 1, n, p->dst) != n)
+        {
+            p->erreur_ecriture = 1;
+        }
+        rendre(&p->sortie);
+    }
+    return NULL;
+}
+
+void init_flux(flux *f, FILE *fic, anneau *a)
+{
+    f->fic = fic;
+    f->a = a;
+    f->tampon = NULL;
+    f->pos = f->taille = 0;
+}
+
+void ouvrir_pipeline(pipeline *p, FILE *src, fonction_lecture lire, void *etat, FILE *dst, long taille)
+{
+    p->src = src;
+    p->dst = dst;
+    p->lire = lire;
+    p->etat = etat;
+    p->lecteur_lance = p->ecrivain_lance = p->erreur_ecriture = 0;
+    init_flux(&p->lecture, src, NULL);
+    init_flux(&p->ecriture, dst, NULL);
+    if (taille < TAILLE_MIN_PIPELINE)
+    {
+        return;
+    }
+    init_anneau(&p->entree);
+    if (pthread_create(&p->lecteur, NULL, fil_lecteur, p) == 0)
+    {
+        p->lecteur_lance = 1;
+        p->lecture.a = &p->entree;
+    }
+    else
+    {
+        free(p->entree.memoire);
+    }
+    if (dst == NULL)
+    {
+        return;
+    }
+    init_anneau(&p->sortie);
+    if (pthread_create(&p->ecrivain, NULL, fil_ecrivain, p) == 0)
+    {
+        p->ecrivain_lance = 1;
+        p->ecriture.a = &p->sortie;
+    }
+    else
+    {
+        free(p->sortie.memoire);
+    }
+}
+
+int fermer_pipeline(pipeline *p)
+{
+    if (p->ecrivain_lance)
+    {
+        if (p->ecriture.tampon != NULL && p->ecriture.pos > 0)
+        {
+            publier(&p->sortie, p->ecriture.pos);
+        }
+        clore(&p->sortie);
+        pthread_join(p->ecrivain, NULL);
+        free(p->sortie.memoire);
+    }
+    if (p->lecteur_lance)
+    {
+        /* l'étape de codage a pu s'arrêter avant la fin (données corrompues) : le lecteur ne doit pas rester bloqué */
+        abandonner(&p->entree);
+        pthread_join(p->lecteur, NULL);
+        free(p->entree.memoire);
+    }
+    p->lecteur_lance = p->ecrivain_lance = 0;
+    return p->erreur_ecriture ? -1 : 0;
+}
@@ -0,0 +1,460 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "prelecture.h"
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+/* étapes faites sur tout un lot */
+#define ETAPE_EXAMEN 0
+#define ETAPE_LECTURE 1
+
+#ifdef __linux__
+/* anneaux d'io_uring partagés avec le noyau, utilisés sans liburing */
+struct anneau_es
+{
+    int fd;
+    unsigned *sq_tete, *sq_queue, *sq_masque, *sq_tableau;
+    struct io_uring_sqe *sqes;
+    unsigned *cq_tete, *cq_queue, *cq_masque;
+    struct io_uring_cqe *cqes;
+    void *sq, *cq;
+    size_t taille_sq, taille_cq, taille_sqes;
+    unsigned nb_prepares;
+    struct statx examens[NB_FICHIERS_LOT];
+    int resultats[2 * NB_FICHIERS_LOT];
+    int descripteurs[NB_FICHIERS_LOT];
+};
+
+static void fermer_anneau(struct anneau_es *a)
+{
+    if (a->sqes != MAP_FAILED)
+    {
+        munmap(a->sqes, a->taille_sqes);
+    }
+    if (a->cq != MAP_FAILED && a->cq != a->sq)
+    {
+        munmap(a->cq, a->taille_cq);
+    }
+    if (a->sq != MAP_FAILED)
+    {
+        munmap(a->sq, a->taille_sq);
+    }
+    close(a->fd);
+    free(a);
+}
+
+/* NULL si le noyau n'a pas io_uring, l'interdit, ou est antérieur aux opérations openat/statx/read (5.6) */
+static struct anneau_es *ouvrir_anneau(void)
+{
+    struct io_uring_params params;
+    struct anneau_es *a;
+    char *sq, *cq;
+
+    if ((a = (struct anneau_es *)malloc(sizeof(struct anneau_es))) == NULL)
+    {
+        return NULL;
+    }
+    memset(&params, 0, sizeof(params));
+    /* une lecture et une fermeture par fichier */
+    if ((a->fd = (int)syscall(__NR_io_uring_setup, 2 * NB_FICHIERS_LOT, &params)) < 0)
+    {
+        free(a);
+        return NULL;
+    }
+    a->sq = a->cq = a->sqes = MAP_FAILED;
+    if (!(params.features & IORING_FEAT_RW_CUR_POS))
+    {
+        fermer_anneau(a);
+        return NULL;
+    }
+    a->taille_sq = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    a->taille_cq = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    a->taille_sqes = params.sq_entries * sizeof(struct io_uring_sqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        a->taille_sq = a->taille_cq = a->taille_sq > a->taille_cq ? a->taille_sq : a->taille_cq;
+    }
+    a->sq = mmap(NULL, a->taille_sq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, a->fd, IORING_OFF_SQ_RING);
+    if (a->sq != MAP_FAILED)
+    {
+        a->cq = (params.features & IORING_FEAT_SINGLE_MMAP) ? a->sq
+                        : mmap(NULL, a->taille_cq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, a->fd, IORING_OFF_CQ_RING);
+    }
+    if (a->cq != MAP_FAILED)
+    {
+        a->sqes = mmap(NULL, a->taille_sqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, a->fd, IORING_OFF_SQES);
+    }
+    if (a->sqes == MAP_FAILED)
+    {
+        fermer_anneau(a);
+        return NULL;
+    }
+    sq = (char *)a->sq;
+    cq = (char *)a->cq;
+    a->sq_tete = (unsigned *)(sq + params.sq_off.head);
+    a->sq_queue = (unsigned *)(sq + params.sq_off.tail);
+    a->sq_masque = (unsigned *)(sq + params.sq_off.ring_mask);
+    a->sq_tableau = (unsigned *)(sq + params.sq_off.array);
+    a->cq_tete = (unsigned *)(cq + params.cq_off.head);
+    a->cq_queue = (unsigned *)(cq + params.cq_off.tail);
+    a->cq_masque = (unsigned *)(cq + params.cq_off.ring_mask);
+    a->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    a->nb_prepares = 0;
+    return a;
+}
+
+/* prépare une opération ; son résultat ira dans a->resultats[donnee] */
+static struct io_uring_sqe *preparer(struct anneau_es *a, int operation, int fd, const void *adresse, unsigned longueur, unsigned donnee)
+{
+    unsigned indice = (*a->sq_queue + a->nb_prepares) & *a->sq_masque;
+    struct io_uring_sqe *sqe = &a->sqes[indice];
+
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = operation;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long)adresse;
+    sqe->len = longueur;
+    sqe->user_data = donnee;
+    a->sq_tableau[indice] = indice;
+    a->nb_prepares++;
+    return sqe;
+}
+
+/* soumet les opérations préparées et attend qu'elles soient toutes finies */
+static void executer(struct anneau_es *a)
+{
+    unsigned nb = a->nb_prepares, a_soumettre = nb, recues = 0, tete;
+    struct io_uring_cqe *cqe;
+    int n;
+
+    __atomic_store_n(a->sq_queue, *a->sq_queue + nb, __ATOMIC_RELEASE);
+    a->nb_prepares = 0;
+    while (recues < nb)
+    {
+        n = (int)syscall(__NR_io_uring_enter, a->fd, a_soumettre, nb - recues, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (n < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            printf("Erreur d'entree/sortie (io_uring)\n");
+            exit(EXIT_FAILURE);
+        }
+        if (n > 0)
+        {
+            a_soumettre -= n;
+        }
+        tete = *a->cq_tete;
+        while (tete != __atomic_load_n(a->cq_queue, __ATOMIC_ACQUIRE))
+        {
+            cqe = &a->cqes[tete & *a->cq_masque];
+            a->resultats[cqe->user_data] = cqe->res;
+            tete++;
+            recues++;
+        }
+        __atomic_store_n(a->cq_tete, tete, __ATOMIC_RELEASE);
+    }
+}
+
+static void examiner_anneau(prelecture *p, int nb)
+{
+    struct anneau_es *a = p->anneau;
+    struct io_uring_sqe *sqe;
+    int i;
+
+    for (i = 0; i < nb; i++)
+    {
+        sqe = preparer(a, IORING_OP_STATX, AT_FDCWD, p->fichiers[i].chemin, STATX_SIZE | STATX_MTIME, i);
+        sqe->off = (unsigned long)&a->examens[i];
+    }
+    executer(a);
+    for (i = 0; i < nb; i++)
+    {
+        if (a->resultats[i] < 0)
+        {
+            p->fichiers[i].erreur = 1;
+            continue;
+        }
+        p->fichiers[i].taille = (long)a->examens[i].stx_size;
+        p->fichiers[i].mtime = (long)a->examens[i].stx_mtime.tv_sec;
+    }
+}
+
+/* ouvre tous les fichiers à lire, puis les lit et les ferme : chaque lecture est liée à la fermeture qui la suit */
+static void lire_anneau(prelecture *p)
+{
+    struct anneau_es *a = p->anneau;
+    fichier_source *f;
+    int i, nb = 0;
+    int *fd = a->descripteurs;
+
+    for (i = 0; i < p->nb; i++)
+    {
+        f = &p->fichiers[i];
+        if (f->contenu != NULL && f->taille > 0)
+        {
+            preparer(a, IORING_OP_OPENAT, AT_FDCWD, f->chemin, 0, NB_FICHIERS_LOT + i)->open_flags = O_RDONLY | O_CLOEXEC;
+            nb++;
+        }
+    }
+    if (nb == 0)
+    {
+        return;
+    }
+    executer(a);
+    for (i = 0; i < p->nb; i++)
+    {
+        f = &p->fichiers[i];
+        if (f->contenu == NULL || f->taille == 0)
+        {
+            continue;
+        }
+        fd[i] = a->resultats[NB_FICHIERS_LOT + i];
+        if (fd[i] < 0)
+        {
+            f->contenu = NULL;
+            continue;
+        }
+        preparer(a, IORING_OP_READ, fd[i], f->contenu, (unsigned)f->taille, i)->flags = IOSQE_IO_LINK;
+        preparer(a, IORING_OP_CLOSE, fd[i], NULL, 0, NB_FICHIERS_LOT + i);
+    }
+    executer(a);
+    for (i = 0; i < p->nb; i++)
+    {
+        f = &p->fichiers[i];
+        if (f->contenu == NULL || f->taille == 0)
+        {
+            continue;
+        }
+        /* lecture courte (le fichier a changé) : il sera lu normalement pendant la compression */
+        if (a->resultats[i] != f->taille)
+        {
+            f->contenu = NULL;
+        }
+        /* une lecture en erreur annule la fermeture liée */
+        if (a->resultats[NB_FICHIERS_LOT + i] == -ECANCELED)
+        {
+            close(fd[i]);
+        }
+    }
+}
+#endif
+
+/* ce que font les fils quand io_uring n'est pas disponible */
+static void examiner(fichier_source *f)
+{
+    struct stat st;
+    if (stat(f->chemin, &st) != 0)
+    {
+        f->erreur = 1;
+        return;
+    }
+    f->taille = st.st_size;
+    f->mtime = st.st_mtime;
+}
+
+static void lire(fichier_source *f)
+{
+    long lu = 0;
+    ssize_t n = 1;
+    int fd;
+
+    if (f->contenu == NULL || f->taille == 0)
+    {
+        return;
+    }
+    if ((fd = open(f->chemin, O_RDONLY | O_CLOEXEC)) < 0)
+    {
+        f->contenu = NULL;
+        return;
+    }
+    while (lu < f->taille && (n = read(fd, f->contenu + lu, f->taille - lu)) > 0)
+    {
+        lu += n;
+    }
+    if (lu != f->taille)
+    {
+        f->contenu = NULL;
+    }
+    close(fd);
+}
+
+typedef struct travail_lecture
+{
+    prelecture *p;
+    int etape, suivant;
+    pthread_mutex_t verrou;
+} travail_lecture;
+
+static void *fil_lecture(void *arg)
+{
+    travail_lecture *t = (travail_lecture *)arg;
+    int i;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&t->verrou);
+        i = t->suivant++;
+        pthread_mutex_unlock(&t->verrou);
+        if (i >= t->p->nb)
+        {
+            return NULL;
+        }
+        if (t->etape == ETAPE_EXAMEN)
+        {
+            examiner(&t->p->fichiers[i]);
+        }
+        else
+        {
+            lire(&t->p->fichiers[i]);
+        }
+    }
+}
+
+static void lancer_fils(prelecture *p, int etape)
+{
+    travail_lecture t;
+    pthread_t fils[NB_FILS_LECTURE];
+    int i, nb_fils = p->nb < NB_FILS_LECTURE ? p->nb : NB_FILS_LECTURE;
+
+    t.p = p;
+    t.etape = etape;
+    t.suivant = 0;
+    pthread_mutex_init(&t.verrou, NULL);
+    for (i = 0; i < nb_fils; i++)
+    {
+        if (pthread_create(&fils[i], NULL, fil_lecture, &t) != 0)
+        {
+            break;
+        }
+    }
+    /* si aucun fil n'a pu démarrer, le travail se fait ici */
+    if (i == 0)
+    {
+        fil_lecture(&t);
+    }
+    while (i > 0)
+    {
+        pthread_join(fils[--i], NULL);
+    }
+    pthread_mutex_destroy(&t.verrou);
+}
+
+void init_prelecture(prelecture *p)
+{
+    p->nb = 0;
+    if ((p->reserve = (unsigned char *)malloc(TAILLE_RESERVE)) == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+#ifdef __linux__
+    p->anneau = ouvrir_anneau();
+#else
+    p->anneau = NULL;
+#endif
+}
+
+int lire_lot(prelecture *p, char **liste, int nb)
+{
+    char *grands[NB_FICHIERS_LOT];
+    unsigned long long empreintes[NB_FICHIERS_LOT];
+    int indices[NB_FICHIERS_LOT];
+    int i, nb_grands = 0;
+    long utilise = 0;
+    fichier_source *f;
+
+    p->nb = nb < NB_FICHIERS_LOT ? nb : NB_FICHIERS_LOT;
+    for (i = 0; i < p->nb; i++)
+    {
+        f = &p->fichiers[i];
+        f->chemin = liste[i];
+        f->contenu = NULL;
+        f->taille = f->mtime = 0;
+        f->empreinte = 0;
+        f->erreur = 0;
+    }
+#ifdef __linux__
+    if (p->anneau != NULL)
+    {
+        examiner_anneau(p, p->nb);
+    }
+    else
+#endif
+    {
+        lancer_fils(p, ETAPE_EXAMEN);
+    }
+
+    /* place des petits fichiers dans la réserve : le lot s'arrête au premier qui n'y tient plus */
+    for (i = 0; i < p->nb; i++)
+    {
+        f = &p->fichiers[i];
+        if (f->erreur || f->taille > TAILLE_MAX_PRELUE)
+        {
+            continue;
+        }
+        if (utilise + f->taille > TAILLE_RESERVE)
+        {
+            break;
+        }
+        f->contenu = p->reserve + utilise;
+        utilise += f->taille;
+    }
+    p->nb = i;
+#ifdef __linux__
+    if (p->anneau != NULL)
+    {
+        lire_anneau(p);
+    }
+    else
+#endif
+    {
+        lancer_fils(p, ETAPE_LECTURE);
+    }
+
+    /* empreintes : en mémoire pour les fichiers prélus, en parallèle sur le disque pour les autres */
+    for (i = 0; i < p->nb; i++)
+    {
+        f = &p->fichiers[i];
+        if (f->contenu != NULL)
+        {
+            f->empreinte = empreinte_contenu(f->contenu, f->taille);
+        }
+        else if (!f->erreur)
+        {
+            indices[nb_grands] = i;
+            grands[nb_grands++] = f->chemin;
+        }
+    }
+    empreintes_fichiers(grands, nb_grands, empreintes);
+    for (i = 0; i < nb_grands; i++)
+    {
+        p->fichiers[indices[i]].empreinte = empreintes[i];
+    }
+    return p->nb;
+}
+
+FILE *ouvrir_source(fichier_source *f)
+{
+    if (f->contenu == NULL)
+    {
+        return fopen(f->chemin, "r");
+    }
+    /* fmemopen refuse une taille nulle sur les anciennes glibc */
+    return f->taille > 0 ? fmemopen(f->contenu, f->taille, "r") : fopen("/dev/null", "r");
+}
+
+void liberer_prelecture(prelecture *p)
+{
+#ifdef __linux__
+    if (p->anneau != NULL)
+    {
+        fermer_anneau(p->anneau);
+    }
+#endif
+    free(p->reserve);
+    p->reserve = NULL;
+    p->anneau = NULL;
+}
@@ -0,0 +1,259 @@
+#include "repertoire.h"
+
+void init_repertoire(repertoire *r)
+{
+    r->entrees = NULL;
+    r->nb = r->capacite = 0;
+    r->par_empreinte = NULL;
+    r->taille_hachage = 0;
+}
+
+/* case de la table où se trouve l'empreinte (ou la case vide où la mettre) */
+static int case_empreinte(repertoire *r, unsigned long long empreinte, long taille)
+{
+    int i = (int)(empreinte & (r->taille_hachage - 1));
+    entree_repertoire *e;
+
+    while (r->par_empreinte[i] != 0)
+    {
+        e = &r->entrees[r->par_empreinte[i] - 1];
+        if (e->empreinte == empreinte && e->taille == taille)
+        {
+            break;
+        }
+        i = (i + 1) & (r->taille_hachage - 1);
+    }
+    return i;
+}
+
+static void indexer_empreinte(repertoire *r, int indice)
+{
+    int i, ancienne_taille = r->taille_hachage, *ancienne = r->par_empreinte;
+    entree_repertoire *e = &r->entrees[indice];
+
+    if (e->empreinte == 0)
+    {
+        return;
+    }
+    /* la table reste au plus à moitié pleine */
+    if (2 * r->nb > r->taille_hachage)
+    {
+        r->taille_hachage = r->taille_hachage == 0 ? 256 : 2 * r->taille_hachage;
+        if ((r->par_empreinte = (int *)calloc(r->taille_hachage, sizeof(int))) == NULL)
+        {
+            printf("Erreur d'allocation memoire\n");
+            exit(EXIT_FAILURE);
+        }
+        for (i = 0; i < ancienne_taille; i++)
+        {
+            if (ancienne[i] != 0)
+            {
+                r->par_empreinte[case_empreinte(r, r->entrees[ancienne[i] - 1].empreinte, r->entrees[ancienne[i] - 1].taille)] = ancienne[i];
+            }
+        }
+        free(ancienne);
+    }
+    i = case_empreinte(r, e->empreinte, e->taille);
+    /* seule la 1ère entrée d'un contenu est retenue : c'est elle qui a le membre complet */
+    if (r->par_empreinte[i] == 0)
+    {
+        r->par_empreinte[i] = indice + 1;
+    }
+}
+
+entree_repertoire *chercher_empreinte(repertoire *r, entree_repertoire *e)
+{
+    int i;
+    if (e->empreinte == 0 || r->taille_hachage == 0)
+    {
+        return NULL;
+    }
+    i = case_empreinte(r, e->empreinte, e->taille);
+    return r->par_empreinte[i] != 0 ? &r->entrees[r->par_empreinte[i] - 1] : NULL;
+}
+
+void ajouter_entree(repertoire *r, entree_repertoire *e)
+{
+    entree_repertoire *copie;
+
+    if (r->nb == r->capacite)
+    {
+        r->capacite = r->capacite == 0 ? 64 : 2 * r->capacite;
+        r->entrees = (entree_repertoire *)realloc(r->entrees, r->capacite * sizeof(entree_repertoire));
+        if (r->entrees == NULL)
+        {
+            printf("Erreur d'allocation memoire\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    copie = &r->entrees[r->nb++];
+    *copie = *e;
+    copie->nom = (char *)malloc(strlen(e->nom) + 1);
+    if (copie->nom == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    strcpy(copie->nom, e->nom);
+    indexer_empreinte(r, r->nb - 1);
+}
+
+void ecrire_repertoire(FILE *fic, repertoire *r)
+{
+    int i, j;
+    entree_repertoire *e;
+    long position = ftell(fic);
+
+    fprintf(fic, "I%d\n", r->nb);
+    for (i = 0; i < r->nb; i++)
+    {
+        e = &r->entrees[i];
+        fprintf(fic, "%ld %ld %ld %08x %ld %ld %016llx %d %s\n", e->position, e->taille_membre, e->taille, e->crc, e->position_table,
+                e->mtime, e->empreinte, e->index.nb, e->nom);
+        if (e->index.nb > 0)
+        {
+            fputc('J', fic);
+            for (j = 0; j < e->index.nb; j++)
+            {
+                fprintf(fic, " %ld %ld %ld", e->index.blocs[j].debut, e->index.blocs[j].position, e->index.blocs[j].position_table);
+            }
+            fputc('\n', fic);
+        }
+    }
+    fprintf(fic, "IDX %020ld\n", position);
+}
+
+long position_repertoire(FILE *fic)
+{
+    char pied[TAILLE_PIED + 1];
+    long position;
+
+    if (fseek(fic, -TAILLE_PIED, SEEK_END) != 0 || fread(pied, 1, TAILLE_PIED, fic) != TAILLE_PIED)
+    {
+        return -1;
+    }
+    pied[TAILLE_PIED] = '\0';
+    if (sscanf(pied, "IDX %ld", &position) != 1)
+    {
+        return -1;
+    }
+    return position;
+}
+
+int lire_repertoire(FILE *fic, repertoire *r)
+{
+    entree_repertoire e;
+    char nom[1024];
+    long position, debut, position_bloc, position_table;
+    int i, j, nb, nb_blocs;
+
+    init_repertoire(r);
+    if ((position = position_repertoire(fic)) < 0 || fseek(fic, position, SEEK_SET) != 0 || fscanf(fic, "I%d", &nb) != 1)
+    {
+        return -1;
+    }
+    for (i = 0; i < nb; i++)
+    {
+        if (fscanf(fic, "%ld %ld %ld %x %ld %ld %llx %d ", &e.position, &e.taille_membre, &e.taille, &e.crc, &e.position_table,
+                   &e.mtime, &e.empreinte, &nb_blocs) != 8 ||
+            fgets(nom, sizeof(nom), fic) == NULL)
+        {
+            liberer_repertoire(r);
+            return -1;
+        }
+        nom[strcspn(nom, "\n")] = '\0';
+        e.nom = nom;
+        e.index.blocs = NULL;
+        e.index.nb = e.index.capacite = 0;
+        if (nb_blocs > 0 && fgetc(fic) != 'J')
+        {
+            liberer_repertoire(r);
+            return -1;
+        }
+        for (j = 0; j < nb_blocs; j++)
+        {
+            if (fscanf(fic, "%ld %ld %ld", &debut, &position_bloc, &position_table) != 3)
+            {
+                liberer_index(&e.index);
+                liberer_repertoire(r);
+                return -1;
+            }
+            indexer_bloc(&e.index, debut, position_bloc, position_table);
+        }
+        ajouter_entree(r, &e);
+    }
+    return 0;
+}
+
+int ouvrir_ajout(FILE *fic, repertoire *r)
+{
+    long position;
+    if (lire_repertoire(fic, r) != 0 || (position = position_repertoire(fic)) < 0 || fseek(fic, position, SEEK_SET) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+entree_repertoire *chercher_entree(repertoire *r, char *nom)
+{
+    int i;
+    /* les membres ajoutés plus tard remplacent ceux de même nom, comme à l'extraction complète */
+    for (i = r->nb - 1; i >= 0; i--)
+    {
+        if (strcmp(r->entrees[i].nom, nom) == 0)
+        {
+            return &r->entrees[i];
+        }
+    }
+    return NULL;
+}
+
+entree_repertoire *entree_a_position(repertoire *r, long position)
+{
+    int bas = 0, haut = r->nb - 1, milieu;
+    while (bas <= haut)
+    {
+        milieu = (bas + haut) / 2;
+        if (r->entrees[milieu].position == position)
+        {
+            return &r->entrees[milieu];
+        }
+        if (r->entrees[milieu].position < position)
+        {
+            bas = milieu + 1;
+        }
+        else
+        {
+            haut = milieu - 1;
+        }
+    }
+    return NULL;
+}
+
+entree_repertoire *chercher_source(repertoire *r, char *nom, entree_repertoire *reference)
+{
+    int i;
+    for (i = r->nb - 1; i >= 0; i--)
+    {
+        if (r->entrees[i].position < reference->position && r->entrees[i].taille == reference->taille &&
+            r->entrees[i].crc == reference->crc && strcmp(r->entrees[i].nom, nom) == 0)
+        {
+            return &r->entrees[i];
+        }
+    }
+    return NULL;
+}
+
+void liberer_repertoire(repertoire *r)
+{
+    int i;
+    for (i = 0; i < r->nb; i++)
+    {
+        free(r->entrees[i].nom);
+        liberer_index(&r->entrees[i].index);
+    }
+    free(r->entrees);
+    free(r->par_empreinte);
+    init_repertoire(r);
+}
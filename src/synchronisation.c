@@ -0,0 +1,293 @@
+#include "synchronisation.h"
+
+/* une part du contenu codé, décodée à partir de son premier bit comme si un code y commençait */
+typedef struct part_origine
+{
+  tache t;                    /* en tête, pour que l'ordonnanceur retrouve la part */
+  const table_codes *table;
+  const unsigned char *code;
+  size_t taille;              /* octets de code */
+  long long debut, limite;    /* bits où commence la part et où commence la suivante */
+  long long fin;              /* frontière où le décodage s'est arrêté : la première >= limite, ou un code invalide */
+  int invalide;
+  unsigned char *departs;     /* bit i à 1 : un code commence au bit debut + i */
+  unsigned char *octets;      /* décodés, dans l'ordre des codes */
+  size_t nb, capacite;
+} part_origine;
+
+int table_origine(noeud *alphabet[], table_codes *t)
+{
+    int i, l, decimal;
+    unsigned int code, debut, j, k;
+
+    memset(t->decodage, 0, sizeof(t->decodage));
+    for (i = 0; i < 256; i++)
+    {
+        t->longueurs[i] = 0;
+        t->codes[i] = 0;
+        if (alphabet[i] == NULL)
+        {
+            continue;
+        }
+        l = alphabet[i]->nbr_bits;
+        if (l < 1 || l > LONGUEUR_MAX_CODE)
+        {
+            return -1;
+        }
+        /* l'en-tête donne le code en chiffres décimaux 0 et 1, sans ses 0 de tête */
+        code = 0;
+        for (decimal = alphabet[i]->codage, k = 0; decimal > 0; decimal /= 10, k++)
+        {
+            if (decimal % 10 > 1 || k >= (unsigned int)l)
+            {
+                return -1;
+            }
+            code |= (unsigned int)(decimal % 10) << k;
+        }
+        t->longueurs[i] = (unsigned char)l;
+        t->codes[i] = code;
+        debut = code << (LONGUEUR_MAX_CODE - l);
+        for (j = 0; j < (1u << (LONGUEUR_MAX_CODE - l)); j++)
+        {
+            /* deux codes dont l'un prolonge l'autre : ce n'est pas un code préfixe */
+            if (t->decodage[debut + j] != 0)
+            {
+                return -1;
+            }
+            t->decodage[debut + j] = (unsigned short)((i << 4) | l);
+        }
+    }
+    return 0;
+}
+
+/* longueur du code qui commence au bit position (0 s'il n'y en a pas) et octet qu'il désigne */
+static int code_a(const table_codes *t, const unsigned char *code, size_t taille, long long position, unsigned char *octet)
+{
+    size_t i = (size_t)(position / 8);
+    unsigned int bits = 0, entree_table;
+    int k;
+
+    for (k = 0; k < 3; k++)
+    {
+        bits = (bits << 8) | (i + k < taille ? code[i + k] : 0);
+    }
+    entree_table = t->decodage[(bits >> (24 - LONGUEUR_MAX_CODE - position % 8)) & ((1u << LONGUEUR_MAX_CODE) - 1)];
+    *octet = (unsigned char)(entree_table >> 4);
+    return entree_table & 15;
+}
+
+static void decoder_part(tache *tache)
+{
+    part_origine *p = (part_origine *)tache;
+    lecteur_bits l = {p->code, p->taille, (size_t)(p->debut / 8), 0, 0};
+    long long position = p->debut;
+    unsigned int entree_table;
+    int longueur;
+
+    /* la part peut commencer au milieu d'un octet */
+    if (position % 8 != 0)
+    {
+        l.acc = l.pos < l.taille ? l.tampon[l.pos] : 0;
+        l.pos++;
+        l.nb = 8 - (int)(position % 8);
+    }
+    while (position < p->limite)
+    {
+        while (l.nb < LONGUEUR_MAX_CODE)
+        {
+            l.acc = (l.acc << 8) | (l.pos < l.taille ? l.tampon[l.pos] : 0);
+            l.pos++;
+            l.nb += 8;
+        }
+        entree_table = p->table->decodage[(l.acc >> (l.nb - LONGUEUR_MAX_CODE)) & ((1u << LONGUEUR_MAX_CODE) - 1)];
+        longueur = entree_table & 15;
+        if (longueur == 0)
+        {
+            /* aucun code ne commence ainsi : la part était mal partie, ou les données sont corrompues */
+            p->invalide = 1;
+            break;
+        }
+        if (p->nb == p->capacite)
+        {
+            p->capacite *= 2;
+            if ((p->octets = (unsigned char *)realloc(p->octets, p->capacite)) == NULL)
+            {
+                printf("Erreur d'allocation memoire\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        p->departs[(position - p->debut) / 8] |= (unsigned char)(0x80 >> ((position - p->debut) % 8));
+        p->octets[p->nb++] = (unsigned char)(entree_table >> 4);
+        l.nb -= longueur;
+        position += longueur;
+    }
+    p->fin = position;
+}
+
+/* vrai si le décodage de la part p a vu un code commencer au bit position */
+static int depart_de(const part_origine *p, long long position)
+{
+    long long i = position - p->debut;
+    return position < p->fin && (p->departs[i / 8] & (0x80 >> (i % 8))) != 0;
+}
+
+/* nombre de codes décodés par la part p avant le bit position */
+static size_t departs_avant(const part_origine *p, long long position)
+{
+    long long i, n = position - p->debut;
+    size_t nb = 0;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        nb += __builtin_popcount(p->departs[i / 8]);
+    }
+    if (i < n)
+    {
+        nb += __builtin_popcount(p->departs[i / 8] & (0xff00 >> (n - i)));
+    }
+    return nb;
+}
+
+static void emettre(FILE *fic_decom, const unsigned char *octets, size_t n, unsigned int *crc)
+{
+    *crc = crc32c(*crc, octets, n);
+    if (fic_decom != NULL && fwrite(octets, 1, n, fic_decom) != n)
+    {
+        printf("Erreur d'ecriture du fichier decompresse\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* recoud les nb parts décodées : position est la frontière exacte atteinte jusque-là, restant les octets encore attendus */
+static int recoudre(part_origine parts[], int nb, long long *position, long *restant, FILE *fic_decom, unsigned int *crc)
+{
+    unsigned char pont[TAILLE_MORCEAU];
+    size_t n = 0, deja;
+    int i, longueur;
+
+    for (i = 0; i < nb; i++)
+    {
+        /* pont : décodage exact, code après code, jusqu'à une frontière que la part a vue elle aussi */
+        while (*position < parts[i].limite && !depart_de(&parts[i], *position))
+        {
+            if (*restant == 0 || (longueur = code_a(parts[i].table, parts[i].code, parts[i].taille, *position, &pont[n])) == 0)
+            {
+                return -1;
+            }
+            *position += longueur;
+            (*restant)--;
+            if (++n == TAILLE_MORCEAU)
+            {
+                emettre(fic_decom, pont, n, crc);
+                n = 0;
+            }
+        }
+        emettre(fic_decom, pont, n, crc);
+        n = 0;
+        if (*position >= parts[i].limite)
+        {
+            continue; /* la part ne s'est jamais resynchronisée : le pont l'a traversée */
+        }
+        /* synchronisée : la suite de la part est le décodage exact, un code invalide y est une vraie corruption */
+        deja = departs_avant(&parts[i], *position);
+        if (parts[i].invalide || parts[i].nb - deja > (size_t)*restant)
+        {
+            return -1;
+        }
+        emettre(fic_decom, parts[i].octets + deja, parts[i].nb - deja, crc);
+        *restant -= (long)(parts[i].nb - deja);
+        *position = parts[i].fin;
+    }
+    return 0;
+}
+
+/* octets lus au-delà de la fin d'un lot : un code commencé avant la fin de sa dernière part peut la déborder */
+#define MARGE_FENETRE 8
+
+int decoder_origine(FILE *fic, FILE *fic_decom, const table_codes *t, long nb_octets, long long nb_bits, ordonnanceur *o, unsigned int *crc)
+{
+    part_origine *parts;
+    tache **taches;
+    unsigned char *fenetre;
+    size_t taille = (size_t)((nb_bits + 7) / 8), debut = 0, lus = 0, fin, capacite;
+    long long position = 0, base, taille_part = 8LL * TAILLE_PART_ORIGINE;
+    long restant = nb_octets;
+    int i, premiere, nb, erreur = 0, nb_lot = o != NULL && o->nb_fils > 0 ? 4 * o->nb_fils : 1;
+
+    *crc = 0;
+    /* le contenu codé est lu par fenêtres d'un lot de parts : la mémoire reste bornée quelle que soit la taille du membre */
+    capacite = (size_t)nb_lot * TAILLE_PART_ORIGINE + MARGE_FENETRE;
+    fenetre = (unsigned char *)malloc(capacite);
+    parts = (part_origine *)malloc(nb_lot * sizeof(part_origine));
+    taches = (tache **)malloc(nb_lot * sizeof(tache *));
+    if (fenetre == NULL || parts == NULL || taches == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    for (premiere = 0; !erreur && (long long)premiere * taille_part < nb_bits; premiere += nb)
+    {
+        /* la fenêtre commence à la 1ère part du lot ; la marge déjà lue pour le lot précédent est gardée */
+        memmove(fenetre, fenetre + ((size_t)premiere * TAILLE_PART_ORIGINE - debut), lus - ((size_t)premiere * TAILLE_PART_ORIGINE - debut));
+        lus -= (size_t)premiere * TAILLE_PART_ORIGINE - debut;
+        debut = (size_t)premiere * TAILLE_PART_ORIGINE;
+        fin = debut + capacite < taille ? debut + capacite : taille;
+        if (fread(fenetre + lus, 1, fin - debut - lus, fic) != fin - debut - lus)
+        {
+            erreur = 1;
+            break;
+        }
+        lus = fin - debut;
+        /* positions en bits relatives à la fenêtre, y compris la frontière exacte reportée d'un lot à l'autre */
+        base = 8LL * (long long)debut;
+        position -= base;
+        for (nb = 0; nb < nb_lot && (long long)(premiere + nb) * taille_part < nb_bits; nb++)
+        {
+            parts[nb].table = t;
+            parts[nb].code = fenetre;
+            parts[nb].taille = lus;
+            parts[nb].debut = (premiere + nb) * taille_part - base;
+            parts[nb].limite = (premiere + nb) * taille_part + taille_part < nb_bits ? parts[nb].debut + taille_part : nb_bits - base;
+            parts[nb].invalide = 0;
+            parts[nb].nb = 0;
+            parts[nb].capacite = TAILLE_PART_ORIGINE;
+            parts[nb].departs = (unsigned char *)calloc((size_t)((parts[nb].limite - parts[nb].debut + 7) / 8), 1);
+            parts[nb].octets = (unsigned char *)malloc(parts[nb].capacite);
+            if (parts[nb].departs == NULL || parts[nb].octets == NULL)
+            {
+                printf("Erreur d'allocation memoire\n");
+                exit(EXIT_FAILURE);
+            }
+            parts[nb].t.cout = TAILLE_PART_ORIGINE;
+            parts[nb].t.executer = decoder_part;
+            taches[nb] = &parts[nb].t;
+        }
+        if (o != NULL && nb > 1)
+        {
+            soumettre_taches(o, taches, nb);
+            for (i = 0; i < nb; i++)
+            {
+                attendre_tache(o, &parts[i].t);
+            }
+        }
+        else
+        {
+            for (i = 0; i < nb; i++)
+            {
+                decoder_part(&parts[i].t);
+            }
+        }
+        erreur = position < 0 || recoudre(parts, nb, &position, &restant, fic_decom, crc) != 0;
+        position += base;
+        for (i = 0; i < nb; i++)
+        {
+            free(parts[i].departs);
+            free(parts[i].octets);
+        }
+    }
+    free(fenetre);
+    free(parts);
+    free(taches);
+    /* le décodage exact doit finir pile sur le dernier bit annoncé, avec tous les octets */
+    return erreur || restant != 0 || position != nb_bits ? -1 : 0;
+}
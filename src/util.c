@@ -1,3 +1,4 @@
+#define _GNU_SOURCE /* copy_file_range */
 #include <util.h>
 
 /*une fonction qui retourne le nombre de lettres dans un alphabet*/
@@ -70,66 +71,6 @@ void afficher_arbre(arbre a, int niveau)
     afficher_arbre(a->f_droit, niveau + 1);
 }
 
-int compter_elements_dossier(char *chemin)
-{
-    DIR *dossier;
-    struct dirent *element;
-    int compteur = 0;
-
-    dossier = opendir(chemin);
-    if (dossier == NULL)
-    {
-        printf("Erreur lors de l'ouverture du dossier\n");
-        return -1;
-    }
-
-    while ((element = readdir(dossier)) != NULL)
-    {
-        compteur++;
-    }
-
-    closedir(dossier);
-
-    return compteur - 2; /* -2 pour enlever ".." et "."du compteur de fichiers */
-}
-
-void lecture_dossier(char *chemin_dossier, char **liste_fichiers, int *indice)
-{
-    DIR *dir;
-    struct dirent *ent;
-    struct stat dir_stat;
-    char chemin_complet[1024];
-    /* ajoute un '/' à la fin du nom s'il n'y en a pas */
-    size_t len = strlen(chemin_dossier);
-    if (chemin_dossier[len - 1] != '/')
-    {
-        chemin_dossier[len] = '/';
-        chemin_dossier[len + 1] = '\0';
-    }
-
-    stat(chemin_dossier, &dir_stat); /* obtenir les infos sur le chemin */
-
-    if ((dir = opendir(chemin_dossier)) != NULL)
-    {
-        while ((ent = readdir(dir)) != NULL)
-        {
-            sprintf(chemin_complet, "%s%s", chemin_dossier, ent->d_name);
-            if (stat(chemin_complet, &dir_stat) == 0 && S_ISREG(dir_stat.st_mode)) /* si elle est un fichier */
-            {
-                {
-                    strcpy(liste_fichiers[*indice], chemin_complet);
-                    (*indice)++;
-                }
-            }
-            else if (S_ISDIR(dir_stat.st_mode) && strcmp(ent->d_name, "..") != 0 && strcmp(ent->d_name, ".") != 0)
-            { /* si elle est un dossier et il ne s agit pas de dossiers speciaux */
-                lecture_dossier(chemin_complet, liste_fichiers, indice);
-            }
-        }
-        closedir(dir);
-    }
-}
-
 void mkdir_p(char *chemin)
 {
     char tmp[1024];
@@ -159,3 +100,125 @@ void mkdir_p(char *chemin)
     }
     mkdir(tmp, 0777);
 }
+
+int copie_brute(FILE *src, FILE *dst, long taille)
+{
+    char tampon[TAILLE_TAMPON_COPIE];
+    size_t n, a_lire;
+#ifdef __linux__
+    off_t pos_src, pos_dst;
+    ssize_t copie;
+
+    /* copie directement entre les descripteurs, sans passer par l'espace utilisateur */
+    fflush(dst);
+    pos_src = ftell(src);
+    pos_dst = ftell(dst);
+    if (pos_src >= 0 && pos_dst >= 0)
+    {
+        while (taille > 0 && (copie = copy_file_range(fileno(src), &pos_src, fileno(dst), &pos_dst, taille, 0)) > 0)
+        {
+            taille -= copie;
+        }
+        /* resynchronise les FILE* avec les positions avancées par le noyau */
+        fseek(src, pos_src, SEEK_SET);
+        fseek(dst, pos_dst, SEEK_SET);
+    }
+#endif
+    /* repli (autre système, autre système de fichiers ou tube) : copie par tampon */
+    while (taille > 0)
+    {
+        a_lire = taille < TAILLE_TAMPON_COPIE ? (size_t)taille : TAILLE_TAMPON_COPIE;
+        if ((n = fread(tampon, 1, a_lire, src)) == 0 || fwrite(tampon, 1, n, dst) != n)
+        {
+            return -1;
+        }
+        taille -= n;
+    }
+    return 0;
+}
+
+int copie_crc(FILE *src, FILE *dst, long taille, unsigned int *crc)
+{
+    unsigned char tampon[TAILLE_TAMPON_COPIE];
+    size_t n, a_lire;
+
+    while (taille > 0)
+    {
+        a_lire = taille < TAILLE_TAMPON_COPIE ? (size_t)taille : TAILLE_TAMPON_COPIE;
+        if ((n = fread(tampon, 1, a_lire, src)) == 0 || (dst != NULL && fwrite(tampon, 1, n, dst) != n))
+        {
+            return -1;
+        }
+        *crc = crc32c(*crc, tampon, n);
+        taille -= n;
+    }
+    return 0;
+}
+
+int nb_fils_disponibles(void)
+{
+    long nb = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nb < 1)
+    {
+        return 1;
+    }
+    return nb > NB_MAX_FILS ? NB_MAX_FILS : (int)nb;
+}
+
+int fichiers_identiques(char *chemin1, FILE *fic2)
+{
+    char tampon1[TAILLE_TAMPON_COPIE], tampon2[TAILLE_TAMPON_COPIE];
+    size_t n1, n2;
+    int identiques = 1;
+    FILE *fic1;
+
+    if ((fic1 = fopen(chemin1, "r")) == NULL)
+    {
+        return 0;
+    }
+    do
+    {
+        n1 = fread(tampon1, 1, TAILLE_TAMPON_COPIE, fic1);
+        n2 = fread(tampon2, 1, TAILLE_TAMPON_COPIE, fic2);
+        identiques = n1 == n2 && memcmp(tampon1, tampon2, n1) == 0;
+    } while (identiques && n1 > 0);
+    fclose(fic1);
+    rewind(fic2);
+    return identiques;
+}
+
+int lier_ou_copier(char *source, char *destination)
+{
+    FILE *src, *dst;
+    struct stat st;
+    int erreur;
+
+    unlink(destination);
+    if (link(source, destination) == 0)
+    {
+        return 0;
+    }
+    /* autre système de fichiers, ou liens physiques non gérés */
+    if (stat(source, &st) != 0 || (src = fopen(source, "r")) == NULL)
+    {
+        return -1;
+    }
+    if ((dst = fopen(destination, "w")) == NULL)
+    {
+        fclose(src);
+        return -1;
+    }
+    erreur = copie_brute(src, dst, st.st_size);
+    fclose(src);
+    return fclose(dst) != 0 || erreur != 0 ? -1 : 0;
+}
+
+int tronquer_fichier(FILE *fic)
+{
+    long position = ftell(fic);
+    if (position < 0 || fflush(fic) != 0)
+    {
+        return -1;
+    }
+    return ftruncate(fileno(fic), position);
+}
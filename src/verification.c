@@ -0,0 +1,196 @@
+#define _GNU_SOURCE
+#include "verification.h"
+
+/* secondes écoulées, horloge monotone */
+static double maintenant(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* débit en Mo/s (10^6 octets), 0 si la durée est trop courte pour être mesurée */
+static double debit(long octets, double duree)
+{
+    return duree > 0 ? octets / duree / 1e6 : 0;
+}
+
+typedef struct travail_test
+{
+    char *chemin;
+    dictionnaire *dico;
+    repertoire *r;
+    int *etats;      /* résultat de verifier_membre pour chaque membre */
+    double *durees;  /* temps de décodage de chaque membre */
+    int suivant;
+    pthread_mutex_t verrou;
+} travail_test;
+
+static void *fil_test(void *arg)
+{
+    travail_test *t = (travail_test *)arg;
+    extraction x;
+    FILE *fic;
+    int i;
+    double debut;
+
+    x.dico = t->dico;
+    x.dossier = NULL;
+    x.renommer = NULL;
+    x.ordonnanceur = NULL; /* les fils se partagent déjà les membres */
+    init_repertoire(&x.repertoire);
+    fic = fopen(t->chemin, "r");
+    for (;;)
+    {
+        pthread_mutex_lock(&t->verrou);
+        i = t->suivant++;
+        pthread_mutex_unlock(&t->verrou);
+        if (i >= t->r->nb)
+        {
+            break;
+        }
+        debut = maintenant();
+        t->etats[i] = fic == NULL ? -1 : verifier_membre(fic, t->r, &t->r->entrees[i], &x);
+        t->durees[i] = maintenant() - debut;
+    }
+    if (fic != NULL)
+    {
+        fclose(fic);
+    }
+    return NULL;
+}
+
+/* archive sans répertoire central (format d'origine, ou écrite avant lui) : les membres sont décodés l'un après l'autre, les
+   membres au format d'origine avec les fils de l'ordonnanceur ; un membre qui ne se décode pas arrête le test, car la suite
+   de l'archive ne peut plus être retrouvée */
+static int tester_sequentiel(FILE *fic, dictionnaire *dico)
+{
+    extraction x;
+    ordonnanceur ord;
+    char nom[500];
+    long taille, total = 0;
+    int etat, nb = 0, nb_erreurs = 0;
+    double debut, debut_total, duree, cumul = 0;
+
+    x.dico = dico;
+    x.dossier = NULL;
+    x.renommer = NULL;
+    x.ordonnanceur = &ord;
+    init_repertoire(&x.repertoire);
+    lancer_ordonnanceur(&ord);
+    printf("Pas de repertoire central : les CRC32C ne sont pas verifies, seul le decodage l'est\n");
+    printf("%-8s %12s %10s %10s  %s\n", "etat", "taille", "ms", "Mo/s", "nom");
+    debut_total = maintenant();
+    for (;;)
+    {
+        debut = maintenant();
+        if ((etat = verifier_membre_suivant(fic, &x, nom, &taille)) == 2)
+        {
+            break;
+        }
+        duree = maintenant() - debut;
+        nb++;
+        if (etat == 1)
+        {
+            printf("%-8s %12ld %10s %10s  %s\n", "DOUBLON", taille, "-", "-", nom);
+            continue;
+        }
+        printf("%-8s %12ld %10.3f %10.1f  %s\n", etat < 0 ? "ERREUR" : "OK", taille, duree * 1000, debit(taille, duree), nom);
+        if (etat < 0)
+        {
+            printf("La suite de l'archive ne peut pas etre lue\n");
+            nb_erreurs++;
+            break;
+        }
+        total += taille;
+        cumul += duree;
+    }
+    duree = maintenant() - debut_total;
+    arreter_ordonnanceur(&ord);
+    printf("%d fichiers testes, %d en erreur : %ld octets en %.3f s, %.1f Mo/s (%d fils par membre)\n", nb, nb_erreurs, total, duree,
+           debit(total, cumul), ord.nb_fils > 0 ? ord.nb_fils : 1);
+    return nb_erreurs;
+}
+
+int tester_archive(char *chemin, dictionnaire *dico)
+{
+    travail_test t;
+    pthread_t fils[NB_MAX_FILS];
+    repertoire r;
+    FILE *fic;
+    int i, nb_fils, nb_erreurs = 0;
+    long total = 0;
+    double debut, duree, cumul = 0;
+
+    if ((fic = fopen(chemin, "r")) == NULL)
+    {
+        printf("L'archive %s est illisible\n", chemin);
+        return -1;
+    }
+    if (lire_repertoire(fic, &r) != 0)
+    {
+        rewind(fic);
+        nb_erreurs = tester_sequentiel(fic, dico);
+        fclose(fic);
+        return nb_erreurs;
+    }
+    fclose(fic);
+    t.etats = (int *)calloc(r.nb > 0 ? r.nb : 1, sizeof(int));
+    t.durees = (double *)calloc(r.nb > 0 ? r.nb : 1, sizeof(double));
+    if (t.etats == NULL || t.durees == NULL)
+    {
+        printf("Erreur d'allocation memoire\n");
+        exit(EXIT_FAILURE);
+    }
+    t.chemin = chemin;
+    t.dico = dico;
+    t.r = &r;
+    t.suivant = 0;
+    pthread_mutex_init(&t.verrou, NULL);
+    debut = maintenant();
+    nb_fils = nb_fils_disponibles();
+    if (nb_fils > r.nb)
+    {
+        nb_fils = r.nb;
+    }
+    for (i = 0; i < nb_fils; i++)
+    {
+        if (pthread_create(&fils[i], NULL, fil_test, &t) != 0)
+        {
+            break;
+        }
+    }
+    if (i == 0)
+    {
+        fil_test(&t);
+    }
+    while (i > 0)
+    {
+        pthread_join(fils[--i], NULL);
+    }
+    duree = maintenant() - debut;
+    pthread_mutex_destroy(&t.verrou);
+
+    printf("%-8s %12s %10s %10s  %s\n", "etat", "taille", "ms", "Mo/s", "nom");
+    for (i = 0; i < r.nb; i++)
+    {
+        if (t.etats[i] == 1)
+        {
+            /* un doublon redécode sa source : il ne compte pas dans le débit */
+            printf("%-8s %12ld %10s %10s  %s\n", "DOUBLON", r.entrees[i].taille, "-", "-", r.entrees[i].nom);
+            continue;
+        }
+        printf("%-8s %12ld %10.3f %10.1f  %s\n", t.etats[i] < 0 ? "ERREUR" : "OK", r.entrees[i].taille, t.durees[i] * 1000,
+               debit(r.entrees[i].taille, t.durees[i]), r.entrees[i].nom);
+        nb_erreurs += t.etats[i] < 0;
+        total += r.entrees[i].taille;
+        cumul += t.durees[i];
+    }
+    /* débit global (tous les fils ensemble) et débit d'un seul fil (temps de décodage cumulé) */
+    printf("%d fichiers testes, %d en erreur : %ld octets en %.3f s, %.1f Mo/s (%.1f Mo/s par fil, %d fils)\n", r.nb, nb_erreurs, total,
+           duree, debit(total, duree), debit(total, cumul), nb_fils > 0 ? nb_fils : 1);
+    free(t.etats);
+    free(t.durees);
+    liberer_repertoire(&r);
+    return nb_erreurs;
+}